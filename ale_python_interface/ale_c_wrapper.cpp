@@ -1,4 +1,5 @@
 #include "ale_c_wrapper.h"
+#include "environment/ale_state_codec.hpp"
 
 #include <cstring>
 #include <string>
@@ -22,4 +23,36 @@ ALEState *decodeState(const char *serialized, int len) {
 	std::string str(serialized, len);
 
 	return new ALEState(str);
-}
\ No newline at end of file
+}
+int encodeStates(ALEState **states, int num_states, char *buf, int buf_len) {
+	std::string block;
+	ALEStateCodec::encode(states, num_states, block);
+
+	if (buf_len >= int(block.length())) {
+		memcpy(buf, block.data(), block.length());
+	}
+
+	return block.length();
+}
+
+int encodeStatesBound(ALEState **states, int num_states) {
+	size_t length = 0;
+	for (int i = 0; i < num_states; i++) {
+		length += states[i]->serialize().length();
+	}
+
+	return ALEStateCodec::maxEncodedSize(length, num_states);
+}
+
+int decodeStatesCount(const char *block, int len) {
+	return ALEStateCodec::count(block, len);
+}
+
+void decodeStates(const char *block, int len, ALEState **states) {
+	std::vector<ALEState> decoded;
+	ALEStateCodec::decode(block, len, decoded);
+
+	for (size_t i = 0; i < decoded.size(); i++) {
+		states[i] = new ALEState(decoded[i]);
+	}
+}
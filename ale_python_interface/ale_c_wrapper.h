@@ -2,6 +2,9 @@
 #define __ALE_C_WRAPPER_H__
 
 #include <ale_interface.hpp>
+#include <ale_vector_interface.hpp>
+#include <ale_episode.hpp>
+#include <ale_rollout_pool.hpp>
 
 extern "C" {
   // Declares int rgb_palette[256]
@@ -53,10 +56,8 @@ extern "C" {
   int lives(ALEInterface *ale){return ale->lives();}
   int getEpisodeFrameNumber(ALEInterface *ale){return ale->getEpisodeFrameNumber();}
   void getScreen(ALEInterface *ale,unsigned char *screen_data){
-    int w = ale->getScreen().width();
-    int h = ale->getScreen().height();
-    pixel_t *ale_screen_data = (pixel_t *)ale->getScreen().getArray();
-    memcpy(screen_data,ale_screen_data,w*h*sizeof(pixel_t));
+    const ALEScreen& screen = ale->getScreen();
+    memcpy(screen_data,screen.getArray(),screen.arraySize());
   }
   void getRAM(ALEInterface *ale,unsigned char *ram){
     unsigned char *ale_ram = ale->getRAM().array();
@@ -68,27 +69,40 @@ extern "C" {
   int getScreenHeight(ALEInterface *ale){return ale->getScreen().height();}
 
   void getScreenRGB(ALEInterface *ale, unsigned char *output_buffer){
-    size_t w = ale->getScreen().width();
-    size_t h = ale->getScreen().height();
-    size_t screen_size = w*h;
-    pixel_t *ale_screen_data = ale->getScreen().getArray();
-
-    ale->theOSystem->colourPalette().applyPaletteRGB(output_buffer, ale_screen_data, screen_size );
+    const ALEScreen& screen = ale->getScreen();
+    ale->theOSystem->colourPalette().applyPaletteRGB(output_buffer, screen.getArray(), screen.arraySize());
   }
 
   void getScreenGrayscale(ALEInterface *ale, unsigned char *output_buffer){
-    size_t w = ale->getScreen().width();
-    size_t h = ale->getScreen().height();
-    size_t screen_size = w*h;
-    pixel_t *ale_screen_data = ale->getScreen().getArray();
+    const ALEScreen& screen = ale->getScreen();
+    ale->theOSystem->colourPalette().applyPaletteGrayscale(output_buffer, screen.getArray(), screen.arraySize());
+  }
+
+  void getScreenPreprocessed(ALEInterface *ale, unsigned char *output_buffer){
+    ale->environment->getScreenPreprocessor().process(output_buffer);
+  }
+  int getPreprocessedWidth(ALEInterface *ale){return ale->getPreprocessedWidth();}
+  int getPreprocessedHeight(ALEInterface *ale){return ale->getPreprocessedHeight();}
+
+  void getFrameStack(ALEInterface *ale, unsigned char *output_buffer){
+    const FrameStack& stack = ale->environment->getFrameStack();
+    memcpy(output_buffer, stack.data(), stack.depth() * stack.frameSize());
+  }
+  int getFrameStackDepth(ALEInterface *ale){return ale->getFrameStackDepth();}
 
-    ale->theOSystem->colourPalette().applyPaletteGrayscale(output_buffer, ale_screen_data, screen_size);
+  // Registers output_buffer to receive the screen in the given ScreenFormat
+  // after every act() and reset_game(); NULL unregisters it.
+  void setScreenBuffer(ALEInterface *ale, unsigned char *output_buffer, int format){
+    ale->setScreenBuffer(output_buffer, (ScreenFormat)format);
   }
 
   void saveState(ALEInterface *ale){ale->saveState();}
   void loadState(ALEInterface *ale){ale->loadState();}
   ALEState* cloneState(ALEInterface *ale){return new ALEState(ale->cloneState());}
+  void cloneStateInto(ALEInterface *ale, ALEState* state){ale->cloneState(*state);}
   void restoreState(ALEInterface *ale, ALEState* state){ale->restoreState(*state);}
+  ALEState* cloneDeltaState(ALEInterface *ale, ALEState* base){return new ALEState(ale->cloneDeltaState(*base));}
+  unsigned long long stateHash(ALEInterface *ale){return ale->stateHash();}
   ALEState* cloneSystemState(ALEInterface *ale){return new ALEState(ale->cloneSystemState());}
   void restoreSystemState(ALEInterface *ale, ALEState* state){ale->restoreSystemState(*state);}
   void deleteState(ALEState* state){delete state;}
@@ -101,6 +115,89 @@ extern "C" {
   int encodeStateLen(ALEState *state);
   ALEState *decodeState(const char *serialized, int len);
 
+  // Encodes num_states states as a single compact block, much smaller than their encodeState()
+  // output together, and returns its length. The block is only written when buf_len is at least
+  // that long; encodeStatesBound returns a length which always suffices.
+  int encodeStates(ALEState **states, int num_states, char *buf, int buf_len);
+  int encodeStatesBound(ALEState **states, int num_states);
+  // Returns the number of states in a block written by encodeStates
+  int decodeStatesCount(const char *block, int len);
+  // Decodes the states of a block into states, which must have room for all of them
+  void decodeStates(const char *block, int len, ALEState **states);
+
+  // On-disk store of states, shared by every process which opens it
+  ALEStateStore *ALEStateStore_new(const char *path, bool writable) {
+    return new ALEStateStore(path, writable);
+  }
+  void ALEStateStore_del(ALEStateStore *store){delete store;}
+  int ALEStateStore_append(ALEStateStore *store, ALEState *state){return store->append(*state);}
+  int ALEStateStore_size(ALEStateStore *store){return store->size();}
+  ALEState *ALEStateStore_get(ALEStateStore *store, int index){return new ALEState(store->getState(index));}
+  void restoreStateFromStore(ALEInterface *ale, ALEStateStore *store, int index){ale->restoreState(*store, index);}
+  void restoreSystemStateFromStore(ALEInterface *ale, ALEStateStore *store, int index){ale->restoreSystemState(*store, index);}
+  // Episode recording and exact replay
+  ALEEpisodeRecorder *ALEEpisodeRecorder_new(ALEInterface *ale, int keyframe_interval) {
+    return new ALEEpisodeRecorder(*ale, keyframe_interval);
+  }
+  void ALEEpisodeRecorder_del(ALEEpisodeRecorder *recorder){delete recorder;}
+  int ALEEpisodeRecorder_act(ALEEpisodeRecorder *recorder, int action){return recorder->act((Action)action);}
+  int ALEEpisodeRecorder_getNumSteps(ALEEpisodeRecorder *recorder){return recorder->getNumSteps();}
+  void ALEEpisodeRecorder_save(ALEEpisodeRecorder *recorder, const char *filename){recorder->save(filename);}
+  ALEEpisodePlayer *ALEEpisodePlayer_new(ALEInterface *ale, const char *filename) {
+    return new ALEEpisodePlayer(*ale, filename);
+  }
+  void ALEEpisodePlayer_del(ALEEpisodePlayer *player){delete player;}
+  int ALEEpisodePlayer_getNumSteps(ALEEpisodePlayer *player){return player->getNumSteps();}
+  int ALEEpisodePlayer_getAction(ALEEpisodePlayer *player, int step){return player->getAction(step);}
+  int ALEEpisodePlayer_getStep(ALEEpisodePlayer *player){return player->getStep();}
+  void ALEEpisodePlayer_seek(ALEEpisodePlayer *player, int step){player->seek(step);}
+  int ALEEpisodePlayer_step(ALEEpisodePlayer *player){return player->step();}
+  // Vectorized interface: several environments stepped together
+  ALEVectorInterface *ALEVector_new(int num_envs, int num_threads) {
+    return new ALEVectorInterface(num_envs, num_threads);
+  }
+  void ALEVector_del(ALEVectorInterface *ale){delete ale;}
+  void ALEVector_setString(ALEVectorInterface *ale,const char *key,const char *value){ale->setString(key,value);}
+  void ALEVector_setInt(ALEVectorInterface *ale,const char *key,int value){ale->setInt(key,value);}
+  void ALEVector_setBool(ALEVectorInterface *ale,const char *key,bool value){ale->setBool(key,value);}
+  void ALEVector_setFloat(ALEVectorInterface *ale,const char *key,float value){ale->setFloat(key,value);}
+  void ALEVector_loadROM(ALEVectorInterface *ale,const char *rom_file){ale->loadROM(rom_file);}
+  void ALEVector_step(ALEVectorInterface *ale,const int *actions,int *rewards,unsigned char *terminals){
+    ale->step((const Action *)actions, rewards, terminals);
+  }
+  void ALEVector_reset_game(ALEVectorInterface *ale){ale->reset_game();}
+  int ALEVector_getNumEnvironments(ALEVectorInterface *ale){return ale->getNumEnvironments();}
+  void ALEVector_getMinimalActionSet(ALEVectorInterface *ale,int *actions){
+    ActionVect action_vect = ale->getMinimalActionSet();
+    for(unsigned int i = 0;i < action_vect.size();i++){
+      actions[i] = action_vect[i];
+    }
+  }
+  int ALEVector_getMinimalActionSize(ALEVectorInterface *ale){return ale->getMinimalActionSet().size();}
+  int ALEVector_getScreenWidth(ALEVectorInterface *ale){return ale->getScreenWidth();}
+  int ALEVector_getScreenHeight(ALEVectorInterface *ale){return ale->getScreenHeight();}
+  void ALEVector_getScreens(ALEVectorInterface *ale,unsigned char *screen_data){
+    size_t size = ale->getNumEnvironments() * ale->getScreenHeight() * ale->getScreenWidth();
+    memcpy(screen_data,ale->getScreens(),size*sizeof(pixel_t));
+  }
+
+  // Rollout pool: an ALEVectorInterface which can also evaluate rollouts, so
+  // that the ALEVector_ functions apply to it as well
+  ALEVectorInterface *ALERolloutPool_new(int num_envs, int num_threads) {
+    return new ALERolloutPool(num_envs, num_threads);
+  }
+  void ALERolloutPool_del(ALEVectorInterface *pool){delete static_cast<ALERolloutPool *>(pool);}
+  // Rollout j plays the lengths[j] actions following those of the rollouts before it
+  void ALERolloutPool_evaluate(ALEVectorInterface *pool, ALEState *root, const int *actions,
+                               const int *lengths, int k, int *returns, unsigned char *terminals){
+    std::vector<ActionSequence> seqs(k);
+    for(int j = 0; j < k; j++){
+      seqs[j].assign((const Action *)actions, (const Action *)actions + lengths[j]);
+      actions += lengths[j];
+    }
+    static_cast<ALERolloutPool *>(pool)->evaluate(*root, seqs.data(), k, returns, terminals);
+  }
+
   // 0: Info, 1: Warning, 2: Error
   void setLoggerMode(int mode) { ale::Logger::setMode(ale::Logger::mode(mode)); }
 }
@@ -2,7 +2,7 @@
 # Author: Ben Goodrich
 # This directly implements a python version of the arcade learning
 # environment interface.
-__all__ = ['ALEInterface']
+__all__ = ['ALEInterface', 'ALEVectorInterface']
 
 from ctypes import *
 import numpy as np
@@ -80,14 +80,32 @@ ale_lib.getScreenRGB.argtypes = [c_void_p, c_void_p]
 ale_lib.getScreenRGB.restype = None
 ale_lib.getScreenGrayscale.argtypes = [c_void_p, c_void_p]
 ale_lib.getScreenGrayscale.restype = None
+ale_lib.getScreenPreprocessed.argtypes = [c_void_p, c_void_p]
+ale_lib.getScreenPreprocessed.restype = None
+ale_lib.getPreprocessedWidth.argtypes = [c_void_p]
+ale_lib.getPreprocessedWidth.restype = c_int
+ale_lib.getPreprocessedHeight.argtypes = [c_void_p]
+ale_lib.getPreprocessedHeight.restype = c_int
+ale_lib.getFrameStack.argtypes = [c_void_p, c_void_p]
+ale_lib.getFrameStack.restype = None
+ale_lib.getFrameStackDepth.argtypes = [c_void_p]
+ale_lib.getFrameStackDepth.restype = c_int
+ale_lib.setScreenBuffer.argtypes = [c_void_p, c_void_p, c_int]
+ale_lib.setScreenBuffer.restype = None
 ale_lib.saveState.argtypes = [c_void_p]
 ale_lib.saveState.restype = None
 ale_lib.loadState.argtypes = [c_void_p]
 ale_lib.loadState.restype = None
 ale_lib.cloneState.argtypes = [c_void_p]
 ale_lib.cloneState.restype = c_void_p
+ale_lib.cloneStateInto.argtypes = [c_void_p, c_void_p]
+ale_lib.cloneStateInto.restype = None
 ale_lib.restoreState.argtypes = [c_void_p, c_void_p]
 ale_lib.restoreState.restype = None
+ale_lib.cloneDeltaState.argtypes = [c_void_p, c_void_p]
+ale_lib.cloneDeltaState.restype = c_void_p
+ale_lib.stateHash.argtypes = [c_void_p]
+ale_lib.stateHash.restype = c_ulonglong
 ale_lib.cloneSystemState.argtypes = [c_void_p]
 ale_lib.cloneSystemState.restype = c_void_p
 ale_lib.restoreSystemState.argtypes = [c_void_p, c_void_p]
@@ -102,8 +120,91 @@ ale_lib.encodeStateLen.argtypes = [c_void_p]
 ale_lib.encodeStateLen.restype = c_int
 ale_lib.decodeState.argtypes = [c_void_p, c_int]
 ale_lib.decodeState.restype = c_void_p
+ale_lib.encodeStates.argtypes = [c_void_p, c_int, c_void_p, c_int]
+ale_lib.encodeStates.restype = c_int
+ale_lib.encodeStatesBound.argtypes = [c_void_p, c_int]
+ale_lib.encodeStatesBound.restype = c_int
+ale_lib.decodeStatesCount.argtypes = [c_void_p, c_int]
+ale_lib.decodeStatesCount.restype = c_int
+ale_lib.decodeStates.argtypes = [c_void_p, c_int, c_void_p]
+ale_lib.decodeStates.restype = None
 ale_lib.setLoggerMode.argtypes = [c_int]
 ale_lib.setLoggerMode.restype = None
+ale_lib.ALEStateStore_new.argtypes = [c_char_p, c_bool]
+ale_lib.ALEStateStore_new.restype = c_void_p
+ale_lib.ALEStateStore_del.argtypes = [c_void_p]
+ale_lib.ALEStateStore_del.restype = None
+ale_lib.ALEStateStore_append.argtypes = [c_void_p, c_void_p]
+ale_lib.ALEStateStore_append.restype = c_int
+ale_lib.ALEStateStore_size.argtypes = [c_void_p]
+ale_lib.ALEStateStore_size.restype = c_int
+ale_lib.ALEStateStore_get.argtypes = [c_void_p, c_int]
+ale_lib.ALEStateStore_get.restype = c_void_p
+ale_lib.restoreStateFromStore.argtypes = [c_void_p, c_void_p, c_int]
+ale_lib.restoreStateFromStore.restype = None
+ale_lib.restoreSystemStateFromStore.argtypes = [c_void_p, c_void_p, c_int]
+ale_lib.restoreSystemStateFromStore.restype = None
+ale_lib.ALEEpisodeRecorder_new.argtypes = [c_void_p, c_int]
+ale_lib.ALEEpisodeRecorder_new.restype = c_void_p
+ale_lib.ALEEpisodeRecorder_del.argtypes = [c_void_p]
+ale_lib.ALEEpisodeRecorder_del.restype = None
+ale_lib.ALEEpisodeRecorder_act.argtypes = [c_void_p, c_int]
+ale_lib.ALEEpisodeRecorder_act.restype = c_int
+ale_lib.ALEEpisodeRecorder_getNumSteps.argtypes = [c_void_p]
+ale_lib.ALEEpisodeRecorder_getNumSteps.restype = c_int
+ale_lib.ALEEpisodeRecorder_save.argtypes = [c_void_p, c_char_p]
+ale_lib.ALEEpisodeRecorder_save.restype = None
+ale_lib.ALEEpisodePlayer_new.argtypes = [c_void_p, c_char_p]
+ale_lib.ALEEpisodePlayer_new.restype = c_void_p
+ale_lib.ALEEpisodePlayer_del.argtypes = [c_void_p]
+ale_lib.ALEEpisodePlayer_del.restype = None
+ale_lib.ALEEpisodePlayer_getNumSteps.argtypes = [c_void_p]
+ale_lib.ALEEpisodePlayer_getNumSteps.restype = c_int
+ale_lib.ALEEpisodePlayer_getAction.argtypes = [c_void_p, c_int]
+ale_lib.ALEEpisodePlayer_getAction.restype = c_int
+ale_lib.ALEEpisodePlayer_getStep.argtypes = [c_void_p]
+ale_lib.ALEEpisodePlayer_getStep.restype = c_int
+ale_lib.ALEEpisodePlayer_seek.argtypes = [c_void_p, c_int]
+ale_lib.ALEEpisodePlayer_seek.restype = None
+ale_lib.ALEEpisodePlayer_step.argtypes = [c_void_p]
+ale_lib.ALEEpisodePlayer_step.restype = c_int
+ale_lib.ALEVector_new.argtypes = [c_int, c_int]
+ale_lib.ALEVector_new.restype = c_void_p
+ale_lib.ALEVector_del.argtypes = [c_void_p]
+ale_lib.ALEVector_del.restype = None
+ale_lib.ALEVector_setString.argtypes = [c_void_p, c_char_p, c_char_p]
+ale_lib.ALEVector_setString.restype = None
+ale_lib.ALEVector_setInt.argtypes = [c_void_p, c_char_p, c_int]
+ale_lib.ALEVector_setInt.restype = None
+ale_lib.ALEVector_setBool.argtypes = [c_void_p, c_char_p, c_bool]
+ale_lib.ALEVector_setBool.restype = None
+ale_lib.ALEVector_setFloat.argtypes = [c_void_p, c_char_p, c_float]
+ale_lib.ALEVector_setFloat.restype = None
+ale_lib.ALEVector_loadROM.argtypes = [c_void_p, c_char_p]
+ale_lib.ALEVector_loadROM.restype = None
+ale_lib.ALEVector_step.argtypes = [c_void_p, c_void_p, c_void_p, c_void_p]
+ale_lib.ALEVector_step.restype = None
+ale_lib.ALEVector_reset_game.argtypes = [c_void_p]
+ale_lib.ALEVector_reset_game.restype = None
+ale_lib.ALEVector_getNumEnvironments.argtypes = [c_void_p]
+ale_lib.ALEVector_getNumEnvironments.restype = c_int
+ale_lib.ALEVector_getMinimalActionSet.argtypes = [c_void_p, c_void_p]
+ale_lib.ALEVector_getMinimalActionSet.restype = None
+ale_lib.ALEVector_getMinimalActionSize.argtypes = [c_void_p]
+ale_lib.ALEVector_getMinimalActionSize.restype = c_int
+ale_lib.ALEVector_getScreenWidth.argtypes = [c_void_p]
+ale_lib.ALEVector_getScreenWidth.restype = c_int
+ale_lib.ALEVector_getScreenHeight.argtypes = [c_void_p]
+ale_lib.ALEVector_getScreenHeight.restype = c_int
+ale_lib.ALEVector_getScreens.argtypes = [c_void_p, c_void_p]
+ale_lib.ALEVector_getScreens.restype = None
+ale_lib.ALERolloutPool_new.argtypes = [c_int, c_int]
+ale_lib.ALERolloutPool_new.restype = c_void_p
+ale_lib.ALERolloutPool_del.argtypes = [c_void_p]
+ale_lib.ALERolloutPool_del.restype = None
+ale_lib.ALERolloutPool_evaluate.argtypes = [c_void_p, c_void_p, c_void_p, c_void_p, c_int,
+                                            c_void_p, c_void_p]
+ale_lib.ALERolloutPool_evaluate.restype = None
 
 class ALEInterface(object):
     # Logger enum
@@ -112,9 +213,16 @@ class ALEInterface(object):
         Warning = 1
         Error = 2
 
+    # ScreenFormat enum
+    class ScreenFormat:
+        Palette = 0
+        RGB = 1
+        Grayscale = 2
+        Preprocessed = 3
 
     def __init__(self):
         self.obj = ale_lib.ALE_new()
+        self._screen_buffer = None
 
     def getString(self, key):
         return ale_lib.getString(self.obj, key)
@@ -136,6 +244,7 @@ class ALEInterface(object):
 
     def loadROM(self, rom_file):
         ale_lib.loadROM(self.obj, rom_file)
+        self._screen_buffer = None
 
     def act(self, action):
         return ale_lib.act(self.obj, int(action))
@@ -245,6 +354,54 @@ class ALEInterface(object):
         ale_lib.getScreenGrayscale(self.obj, as_ctypes(screen_data[:]))
         return screen_data
 
+    def getPreprocessedDims(self):
+        """returns a tuple that contains (height, width) of the preprocessed
+        screen, as set by the preprocess_height and preprocess_width settings
+        """
+        width = ale_lib.getPreprocessedWidth(self.obj)
+        height = ale_lib.getPreprocessedHeight(self.obj)
+        return (height, width)
+
+    def getScreenPreprocessed(self, screen_data=None):
+        """This function fills screen_data with the preprocessed screen:
+        grayscale, max-pooled over the last two frames if preprocess_max_pool
+        is set, and resized to getPreprocessedDims().
+        screen_data MUST be a numpy array of uint8. This can be initialized like so:
+        screen_data = np.empty((height,width), dtype=np.uint8)
+        If it is None,  then this function will initialize it.
+        """
+        if(screen_data is None):
+            screen_data = np.empty(self.getPreprocessedDims(), dtype=np.uint8)
+        ale_lib.getScreenPreprocessed(self.obj, as_ctypes(screen_data[:]))
+        return screen_data
+
+    def getFrameStack(self, stack_data=None):
+        """This function fills stack_data with the last frame_stack
+        preprocessed screens, oldest first, in a single copy.
+        stack_data MUST be a numpy array of uint8. This can be initialized like so:
+        stack_data = np.empty((depth,height,width), dtype=np.uint8)
+        If it is None,  then this function will initialize it.
+        """
+        if(stack_data is None):
+            depth = ale_lib.getFrameStackDepth(self.obj)
+            stack_data = np.empty((depth,) + self.getPreprocessedDims(), dtype=np.uint8)
+        ale_lib.getFrameStack(self.obj, as_ctypes(stack_data[:]))
+        return stack_data
+
+    def setScreenBuffer(self, screen_data, screen_format=ScreenFormat.Palette):
+        """Registers screen_data to be overwritten with the screen, in the given
+        ScreenFormat, after every act() and reset_game(). screen_data MUST be a
+        C-contiguous numpy array of uint8 with width*height elements (times 3 for
+        ScreenFormat.RGB, getPreprocessedDims() for ScreenFormat.Preprocessed). Pass None to stop updating it. Loading a ROM drops
+        the registered buffer.
+        """
+        if screen_data is None:
+            ale_lib.setScreenBuffer(self.obj, None, 0)
+        else:
+            ale_lib.setScreenBuffer(self.obj, as_ctypes(screen_data[:]), screen_format)
+        # Keep a reference so the array outlives its registration
+        self._screen_buffer = screen_data
+
     def getRAMSize(self):
         return ale_lib.getRAMSize(self.obj)
 
@@ -273,12 +430,18 @@ class ALEInterface(object):
         """Loads the state of the system"""
         return ale_lib.loadState(self.obj)
 
-    def cloneState(self):
+    def cloneState(self, state=None):
         """This makes a copy of the environment state. This copy does *not*
         include pseudorandomness, making it suitable for planning
         purposes. By contrast, see cloneSystemState.
+
+        If state is given, the copy is stored into it instead of a new
+        state, reusing its memory, and state is returned.
         """
-        return ale_lib.cloneState(self.obj)
+        if state is None:
+            return ale_lib.cloneState(self.obj)
+        ale_lib.cloneStateInto(self.obj, state)
+        return state
 
     def restoreState(self, state):
         """Reverse operation of cloneState(). This does not restore
@@ -288,6 +451,20 @@ class ALEInterface(object):
         """
         ale_lib.restoreState(self.obj, state)
 
+    def cloneDeltaState(self, base):
+        """Like cloneState(), but the copy only stores its differences
+        from base, another state returned by cloneState() or
+        cloneDeltaState(). base may be deleted while the copy is in use.
+        """
+        return ale_lib.cloneDeltaState(self.obj, base)
+
+    def stateHash(self):
+        """Returns a 64-bit hash of the state cloneState() would copy,
+        without making the copy. Equal states hash equally whatever their
+        frame number.
+        """
+        return ale_lib.stateHash(self.obj)
+
     def cloneSystemState(self):
         """This makes a copy of the system & environment state, suitable for
         serialization. This includes pseudorandomness and so is *not*
@@ -299,6 +476,16 @@ class ALEInterface(object):
         """Reverse operation of cloneSystemState."""
         ale_lib.restoreSystemState(self.obj, state)
 
+    def restoreStateFromStore(self, store, index):
+        """Restores the state at the given index of an ALEStateStore,
+        reading it in place from the store's memory mapping.
+        """
+        ale_lib.restoreStateFromStore(self.obj, store.obj, index)
+
+    def restoreSystemStateFromStore(self, store, index):
+        """As restoreStateFromStore, for states from cloneSystemState."""
+        ale_lib.restoreSystemStateFromStore(self.obj, store.obj, index)
+
     def deleteState(self, state):
         """ Deallocates the ALEState """
         ale_lib.deleteState(state)
@@ -316,6 +503,27 @@ class ALEInterface(object):
     def decodeState(self, serialized):
         return ale_lib.decodeState(as_ctypes(serialized), len(serialized))
 
+    def encodeStates(self, states):
+        """Encodes a list of states as a single compact block, returned as
+        a uint8 array. Related states, such as neighbouring nodes of a
+        search tree, compress best when encoded together.
+        """
+        handles = (c_void_p * len(states))(*states)
+        length = ale_lib.encodeStatesBound(handles, len(states))
+        buf = np.zeros(length, dtype=np.uint8)
+        length = ale_lib.encodeStates(handles, len(states), as_ctypes(buf),
+                                      c_int(len(buf)))
+        return buf[:length]
+
+    def decodeStates(self, block):
+        """Reverse operation of encodeStates(); returns a list of states,
+        each to be released with deleteState().
+        """
+        count = ale_lib.decodeStatesCount(as_ctypes(block), len(block))
+        handles = (c_void_p * count)()
+        ale_lib.decodeStates(as_ctypes(block), len(block), handles)
+        return list(handles)
+
     def __del__(self):
         ale_lib.ALE_del(self.obj)
 
@@ -325,3 +533,184 @@ class ALEInterface(object):
         mode = dic.get(mode, mode)
         assert mode in [0, 1, 2], "Invalid Mode! Mode must be one of 0: info, 1: warning, 2: error"
         ale_lib.setLoggerMode(mode)
+
+
+class ALEStateStore(object):
+    """An append-only file of states, memory-mapped so that every process
+    reading it shares a single copy. Any number of processes may read the
+    store while others append to it.
+    """
+
+    def __init__(self, path, writable=False):
+        self.obj = ale_lib.ALEStateStore_new(path, writable)
+
+    def append(self, state):
+        """Appends a state and returns its index"""
+        return ale_lib.ALEStateStore_append(self.obj, state)
+
+    def __len__(self):
+        return ale_lib.ALEStateStore_size(self.obj)
+
+    def get(self, index):
+        """Returns a copy of the state at index, to be released with
+        deleteState(). restoreStateFromStore() avoids the copy.
+        """
+        return ale_lib.ALEStateStore_get(self.obj, index)
+
+    def __del__(self):
+        ale_lib.ALEStateStore_del(self.obj)
+
+
+class ALEEpisodeRecorder(object):
+    """Records an episode played through ale as its start state, its
+    actions and a keyframe every keyframe_interval steps. Actions must go
+    through act() rather than ale.act().
+    """
+
+    def __init__(self, ale, keyframe_interval=1000):
+        self.ale = ale
+        self.obj = ale_lib.ALEEpisodeRecorder_new(ale.obj, keyframe_interval)
+
+    def act(self, action):
+        return ale_lib.ALEEpisodeRecorder_act(self.obj, int(action))
+
+    def getNumSteps(self):
+        return ale_lib.ALEEpisodeRecorder_getNumSteps(self.obj)
+
+    def save(self, filename):
+        ale_lib.ALEEpisodeRecorder_save(self.obj, filename)
+
+    def __del__(self):
+        ale_lib.ALEEpisodeRecorder_del(self.obj)
+
+
+class ALEEpisodePlayer(object):
+    """Replays an episode saved by ALEEpisodeRecorder into ale, which must
+    have loaded the same ROM with the same settings.
+    """
+
+    def __init__(self, ale, filename):
+        self.ale = ale
+        self.obj = ale_lib.ALEEpisodePlayer_new(ale.obj, filename)
+
+    def getNumSteps(self):
+        return ale_lib.ALEEpisodePlayer_getNumSteps(self.obj)
+
+    def getAction(self, step):
+        return ale_lib.ALEEpisodePlayer_getAction(self.obj, step)
+
+    def getStep(self):
+        return ale_lib.ALEEpisodePlayer_getStep(self.obj)
+
+    def seek(self, step):
+        """Brings ale to the state after the given number of steps"""
+        ale_lib.ALEEpisodePlayer_seek(self.obj, step)
+
+    def step(self):
+        """Plays the next step and returns its reward"""
+        return ale_lib.ALEEpisodePlayer_step(self.obj)
+
+    def __del__(self):
+        ale_lib.ALEEpisodePlayer_del(self.obj)
+
+
+class ALEVectorInterface(object):
+    """Steps num_envs environments together on a pool of native threads.
+    num_threads = 0 uses one thread per hardware thread.
+    """
+
+    def __init__(self, num_envs, num_threads=0):
+        self.obj = ale_lib.ALEVector_new(num_envs, num_threads)
+        self.num_envs = num_envs
+        self.rewards = np.zeros(num_envs, dtype=np.intc)
+        self.terminals = np.zeros(num_envs, dtype=np.uint8)
+
+    def setString(self, key, value):
+      ale_lib.ALEVector_setString(self.obj, key, value)
+    def setInt(self, key, value):
+      ale_lib.ALEVector_setInt(self.obj, key, value)
+    def setBool(self, key, value):
+      ale_lib.ALEVector_setBool(self.obj, key, value)
+    def setFloat(self, key, value):
+      ale_lib.ALEVector_setFloat(self.obj, key, value)
+
+    def loadROM(self, rom_file):
+        ale_lib.ALEVector_loadROM(self.obj, rom_file)
+
+    def step(self, actions):
+        """Applies actions[i] to environment i. Returns the arrays of
+        rewards and terminal flags; these are reused across calls.
+        Environments in a terminal state are reset before acting.
+        """
+        actions = np.ascontiguousarray(actions, dtype=np.intc)
+        assert len(actions) == self.num_envs
+        ale_lib.ALEVector_step(self.obj, as_ctypes(actions),
+                               as_ctypes(self.rewards), as_ctypes(self.terminals))
+        return self.rewards, self.terminals
+
+    def reset_game(self):
+        ale_lib.ALEVector_reset_game(self.obj)
+
+    def getMinimalActionSet(self):
+        act_size = ale_lib.ALEVector_getMinimalActionSize(self.obj)
+        act = np.zeros((act_size), dtype=np.intc)
+        ale_lib.ALEVector_getMinimalActionSet(self.obj, as_ctypes(act))
+        return act
+
+    def getScreenDims(self):
+        """returns a tuple that contains (screen_width, screen_height)
+        """
+        width = ale_lib.ALEVector_getScreenWidth(self.obj)
+        height = ale_lib.ALEVector_getScreenHeight(self.obj)
+        return (width, height)
+
+    def getScreens(self, screen_data=None):
+        """Fills screen_data with the raw screens of all environments.
+        screen_data MUST be a numpy array of uint8 of shape
+        (num_envs, height, width). If it is None, it is allocated here.
+        """
+        if(screen_data is None):
+            width = ale_lib.ALEVector_getScreenWidth(self.obj)
+            height = ale_lib.ALEVector_getScreenHeight(self.obj)
+            screen_data = np.empty((self.num_envs, height, width), dtype=np.uint8)
+        ale_lib.ALEVector_getScreens(self.obj, as_ctypes(screen_data[:]))
+        return screen_data
+
+    def __del__(self):
+        ale_lib.ALEVector_del(self.obj)
+
+
+class ALERolloutPool(ALEVectorInterface):
+    """Plays rollouts of action sequences from a common root state on
+    num_envs environments at once; num_envs = 0 uses one per hardware
+    thread. Settings and loadROM() apply to every environment.
+    """
+
+    def __init__(self, num_envs=0, num_threads=0):
+        self.obj = ale_lib.ALERolloutPool_new(num_envs, num_threads)
+        self.num_envs = ale_lib.ALEVector_getNumEnvironments(self.obj)
+        self.rewards = np.zeros(self.num_envs, dtype=np.intc)
+        self.terminals = np.zeros(self.num_envs, dtype=np.uint8)
+
+    def evaluate(self, root, sequences):
+        """Plays each sequence of actions from root, a state returned by
+        cloneState(). Returns the arrays of the total reward of each
+        rollout and of whether the game ended during it.
+        """
+        k = len(sequences)
+        returns = np.zeros(k, dtype=np.intc)
+        terminals = np.zeros(k, dtype=np.uint8)
+        if k == 0:
+            return returns, terminals
+        lengths = np.array([len(seq) for seq in sequences], dtype=np.intc)
+        # Sequences are passed back to back; one extra slot keeps the array non-empty
+        actions = np.zeros(lengths.sum() + 1, dtype=np.intc)
+        if lengths.sum() > 0:
+            actions[:-1] = np.concatenate(sequences)
+        ale_lib.ALERolloutPool_evaluate(self.obj, root, as_ctypes(actions),
+                                        as_ctypes(lengths), k, as_ctypes(returns),
+                                        as_ctypes(terminals))
+        return returns, terminals
+
+    def __del__(self):
+        ale_lib.ALERolloutPool_del(self.obj)
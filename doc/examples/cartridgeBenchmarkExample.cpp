@@ -0,0 +1,112 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  cartridgeBenchmarkExample.cpp
+ *
+ *  Times emulation per cartridge type and CPU core. A 4K ROM is repeated into
+ *  16K and 32K images, which are detected as F6 and F4 cartridges; the same
+ *  code then runs behind each bank switching scheme. Running the program
+ *  against two builds of the library compares them.
+ **************************************************************************** */
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <ale_interface.hpp>
+
+using namespace std;
+
+// Writes the image repeated to the given size, and returns the file's name. The ROM's own
+//  name is kept, since the game is recognized by it
+static string writeImage(const string& image, size_t size, const string& type,
+                         const string& rom_file) {
+    string directory = (getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp") + string("/ale-") + type;
+    mkdir(directory.c_str(), 0755);
+    string filename = directory + "/" + rom_file.substr(rom_file.find_last_of('/') + 1);
+    ofstream out(filename.c_str(), ios::binary);
+    for (size_t written = 0; written < size; written += image.size())
+        out.write(image.data(), image.size());
+    return filename;
+}
+
+// Returns the time per step in microseconds, and the RAM after the last step in ram
+static double run(const string& rom_file, const string& cpu, int num_steps, ALERAM& ram) {
+    ALEInterface ale;
+    ale.setInt("random_seed", 123);
+    ale.setString("cpu", cpu);
+    ale.loadROM(rom_file);
+
+    ActionVect legal_actions = ale.getLegalActionSet();
+    srand(123);
+    clock_t start = clock();
+    for (int step = 0; step < num_steps; step++) {
+        if (ale.game_over())
+            ale.reset_game();
+        ale.act(legal_actions[rand() % legal_actions.size()]);
+    }
+    clock_t end = clock();
+
+    ram = ale.getRAM();
+    return 1e6 * (end - start) / CLOCKS_PER_SEC / num_steps;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " rom_file [num_steps]" << std::endl;
+        return 1;
+    }
+    int num_steps = argc > 2 ? atoi(argv[2]) : 4000;
+
+    ifstream in(argv[1], ios::binary);
+    string image((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    if (image.size() != 4096) {
+        std::cerr << argv[1] << " is not a 4K ROM" << std::endl;
+        return 1;
+    }
+
+    string roms[3] = { argv[1], writeImage(image, 16384, "F6", argv[1]),
+                       writeImage(image, 32768, "F4", argv[1]) };
+    const char* cpus[3] = { "low", "high", "threaded" };
+
+    // The images hold the same code, so each core must end in the same state on all of them
+    vector<string> results;
+    bool same = true;
+    for (int c = 0; c < 3; c++) {
+        ALERAM reference;
+        string line = string(cpus[c]) + "\t";
+        for (int t = 0; t < 3; t++) {
+            ALERAM ram;
+            double us = run(roms[t], cpus[c], num_steps, ram);
+            if (t == 0)
+                reference = ram;
+            same = same && ram.equals(reference);
+            char field[16];
+            snprintf(field, sizeof(field), "%.1f\t", us);
+            line += field;
+        }
+        results.push_back(line);
+    }
+
+    cout << "us per step over " << num_steps << " steps" << endl;
+    cout << "core\t4K\tF6\tF4" << endl;
+    for (size_t i = 0; i < results.size(); i++)
+        cout << results[i] << endl;
+
+    if (!same)
+        cerr << "The cartridge types ended in different states" << endl;
+    return same ? 0 : 1;
+}
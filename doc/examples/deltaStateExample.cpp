@@ -0,0 +1,104 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  deltaStateExample.cpp
+ *
+ *  Grows a random search tree the way a planner would: each node is reached by
+ *  restoring a random node, acting once and storing the result with
+ *  cloneDeltaState(). Frame stacking is on, so nodes also carry their stacks.
+ *  Every node is then restored and checked against the RAM, state hash and
+ *  frame stack seen when it was stored. The time per stored node and the peak
+ *  memory use are reported.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <ale_interface.hpp>
+
+using namespace std;
+
+// What a node must look like once restored
+struct Expected {
+    ALERAM ram;
+    uint64_t hash;
+    uint64_t stack_hash;
+};
+
+static void observe(ALEInterface& ale, size_t stack_size, Expected& expected) {
+    expected.ram = ale.getRAM();
+    expected.hash = ale.stateHash();
+    // The stacks are hashed rather than kept, so that they do not dominate the memory use
+    const unsigned char* stack = ale.getFrameStack();
+    expected.stack_hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < stack_size; i++)
+        expected.stack_hash = (expected.stack_hash ^ stack[i]) * 1099511628211ULL;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " rom_file [num_nodes]" << std::endl;
+        return 1;
+    }
+    int num_nodes = argc > 2 ? atoi(argv[2]) : 2000;
+
+    ALEInterface ale;
+    ale.setInt("random_seed", 123);
+    ale.setInt("frame_skip", 4);
+    ale.setInt("frame_stack", 4);
+    ale.loadROM(argv[1]);
+
+    ActionVect legal_actions = ale.getLegalActionSet();
+    size_t stack_size = (size_t)ale.getFrameStackDepth() * ale.getPreprocessedHeight() *
+        ale.getPreprocessedWidth();
+
+    vector<ALEState> nodes;
+    vector<Expected> expected(num_nodes + 1);
+    nodes.push_back(ale.cloneState());
+    observe(ale, stack_size, expected[0]);
+
+    srand(123);
+    clock_t cloning = 0;
+    for (int i = 1; i <= num_nodes; i++) {
+        // Expand the newest node most of the time, as a depth-first search would
+        int parent = rand() % 4 == 0 ? rand() % nodes.size() : nodes.size() - 1;
+        ale.restoreState(nodes[parent]);
+        ale.act(legal_actions[rand() % legal_actions.size()]);
+
+        clock_t start = clock();
+        nodes.push_back(ale.cloneDeltaState(nodes[parent]));
+        cloning += clock() - start;
+        observe(ale, stack_size, expected[i]);
+    }
+
+    int mismatches = 0;
+    for (int i = num_nodes; i >= 0; i--) {
+        ale.restoreState(nodes[i]);
+        Expected restored;
+        observe(ale, stack_size, restored);
+        if (!restored.ram.equals(expected[i].ram) || restored.hash != expected[i].hash ||
+            restored.stack_hash != expected[i].stack_hash) {
+            if (mismatches == 0)
+                cerr << "Node " << i << " differs once restored" << endl;
+            mismatches++;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    cout << num_nodes << " nodes, " << 1e6 * cloning / CLOCKS_PER_SEC / num_nodes
+         << " us per cloneDeltaState, peak memory " << usage.ru_maxrss / 1024 << " MB, "
+         << mismatches << " mismatches" << endl;
+    return mismatches == 0 ? 0 : 1;
+}
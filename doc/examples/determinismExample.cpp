@@ -0,0 +1,150 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  determinismExample.cpp
+ *
+ *  Checks that the settings which only make emulation cheaper leave the
+ *  environment unchanged: two interfaces, one with the setting off and one
+ *  with it on, are stepped with the same actions and compared after every step.
+ *  The checks run on one ROM, or on every ROM in a directory.
+ *
+ *  fast_tia_update skips drawing altogether, so RAM, rewards, terminal flags and
+ *  CPU cycles are compared. render_final_frames must also give the same
+ *  observations, so screens are compared as well, in particular on the step
+ *  ending each episode. The threaded CPU core is compared with the high
+ *  compatibility one it implements in the same way. So are the TIA's SSSE3
+ *  renderer with its scalar loops, and its lazily computed collisions with
+ *  collisions computed as they are drawn; those two are compared on every frame.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <dirent.h>
+#include <ale_interface.hpp>
+#include <emucore/m6502/src/System.hxx>
+
+using namespace std;
+
+// Sets a boolean setting from "true" or "false", and any other setting as a string
+static void set(ALEInterface& ale, const string& setting, const string& value) {
+    if (value == "true" || value == "false")
+        ale.setBool(setting, value == "true");
+    else
+        ale.setString(setting, value);
+}
+
+static uInt32 cycles(ALEInterface& ale) {
+    return ale.theOSystem->console().system().cycles();
+}
+
+// Compares two interfaces stepped with the same actions, the reference one with setting set to
+//  reference_value and the tested one with tested_value; returns the number of mismatches
+static int compare(const string& rom_file, const string& setting, const string& reference_value,
+                   const string& tested_value, int frame_skip, bool compare_screens,
+                   int max_num_frames, int num_episodes) {
+    ALEInterface reference, tested;
+    ALEInterface* ales[2] = { &reference, &tested };
+    for (int i = 0; i < 2; i++) {
+        ales[i]->setInt("random_seed", 123);
+        ales[i]->setInt("frame_skip", frame_skip);
+        ales[i]->setInt("max_num_frames_per_episode", max_num_frames);
+        ales[i]->setBool("color_averaging", true);
+        ales[i]->setBool("render_final_frames", false);
+        ales[i]->setBool("fast_tia_update", false);
+    }
+    set(reference, setting, reference_value);
+    set(tested, setting, tested_value);
+    reference.loadROM(rom_file);
+    tested.loadROM(rom_file);
+
+    ActionVect legal_actions = reference.getLegalActionSet();
+    vector<unsigned char> reference_screen, tested_screen;
+    int mismatches = 0, steps = 0;
+
+    srand(123);
+    for (int episode = 0; episode < num_episodes; episode++) {
+        while (!reference.game_over() || !tested.game_over()) {
+            Action a = legal_actions[rand() % legal_actions.size()];
+            reward_t reference_reward = reference.act(a);
+            reward_t tested_reward = tested.act(a);
+            steps++;
+
+            bool same = reference_reward == tested_reward &&
+                reference.game_over() == tested.game_over() &&
+                reference.getRAM().equals(tested.getRAM()) &&
+                cycles(reference) == cycles(tested);
+            if (compare_screens) {
+                reference.getScreenRGB(reference_screen);
+                tested.getScreenRGB(tested_screen);
+                same = same && reference_screen == tested_screen;
+            }
+            if (!same) {
+                if (mismatches == 0)
+                    cerr << rom_file << ", " << setting << "=" << tested_value << ": episode "
+                         << episode << " differs at frame " << reference.getEpisodeFrameNumber()
+                         << endl;
+                mismatches++;
+            }
+        }
+        reference.reset_game();
+        tested.reset_game();
+    }
+
+    cout << rom_file << ", " << setting << "=" << tested_value << " against " << reference_value
+         << " (max_num_frames_per_episode=" << max_num_frames << "): " << steps << " steps, "
+         << mismatches << " mismatches" << endl;
+    return mismatches;
+}
+
+// Returns the ROM files in path if it is a directory, and path itself otherwise
+static vector<string> romFiles(const string& path) {
+    vector<string> rom_files;
+    DIR* directory = opendir(path.c_str());
+    if (directory == NULL) {
+        rom_files.push_back(path);
+        return rom_files;
+    }
+    while (struct dirent* entry = readdir(directory)) {
+        string name = entry->d_name;
+        if (name.length() > 4 && name.substr(name.length() - 4) == ".bin")
+            rom_files.push_back(path + "/" + name);
+    }
+    closedir(directory);
+    sort(rom_files.begin(), rom_files.end());
+    return rom_files;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " rom_file_or_directory" << std::endl;
+        return 1;
+    }
+
+    // Episodes are also cut short at a frame count which is not a multiple of frame_skip, so
+    //  that they end on frames render_final_frames would not draw
+    int mismatches = 0;
+    vector<string> rom_files = romFiles(argv[1]);
+    for (size_t i = 0; i < rom_files.size(); i++) {
+        const string& rom = rom_files[i];
+        mismatches += compare(rom, "fast_tia_update", "false", "true", 4, false, 18000, 2);
+        mismatches += compare(rom, "render_final_frames", "false", "true", 4, true, 18000, 2);
+        mismatches += compare(rom, "render_final_frames", "false", "true", 4, true, 1001, 3);
+        mismatches += compare(rom, "render_final_frames", "false", "true", 4, true, 1002, 3);
+        mismatches += compare(rom, "cpu", "high", "threaded", 4, true, 18000, 2);
+        mismatches += compare(rom, "vector_tia_update", "false", "true", 1, true, 18000, 2);
+        mismatches += compare(rom, "lazy_tia_collisions", "false", "true", 1, true, 18000, 2);
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  paletteBenchmarkExample.cpp
+ *
+ *  Times the scalar, SSSE3 and AVX2 kernels of ColourPalette::applyPaletteRGB
+ *  and applyPaletteGrayscale on 210x160 frames. Every kernel the CPU supports
+ *  must give the same bytes as the scalar one, for every palette and for
+ *  buffer sizes which leave the vector loops with a scalar tail.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <common/ColourPalette.hpp>
+
+using namespace std;
+
+static const size_t FRAME_SIZE = 210 * 160;
+
+// Converts src with the scalar kernels and with the given ones; returns whether they agree
+static bool sameOutput(ColourPalette& palette, const string& kernels, vector<uInt8>& src,
+                       size_t size) {
+    vector<unsigned char> rgb[2], grayscale[2];
+    const string names[2] = { "scalar", kernels };
+    for (int k = 0; k < 2; k++) {
+        palette.setKernels(names[k]);
+        palette.applyPaletteRGB(rgb[k], &src[0], size);
+        palette.applyPaletteGrayscale(grayscale[k], &src[0], size);
+    }
+    return rgb[0] == rgb[1] && grayscale[0] == grayscale[1];
+}
+
+int main(int argc, char** argv) {
+    int num_frames = argc > 1 ? atoi(argv[1]) : 2000;
+
+    // Screens hold even palette indices; the odd entries are the grayscale ones
+    srand(123);
+    vector<uInt8> frames(8 * FRAME_SIZE);
+    for (size_t i = 0; i < frames.size(); i++)
+        frames[i] = (rand() % 128) * 2;
+
+    const char* types[2] = { "standard", "z26" };
+    const char* formats[3] = { "NTSC", "PAL", "SECAM" };
+    const char* kernels[3] = { "scalar", "ssse3", "avx2" };
+    ColourPalette palette;
+
+    bool same = true;
+    for (int k = 1; k < 3; k++) {
+        if (!palette.setKernels(kernels[k]))
+            continue;
+        for (int t = 0; t < 2; t++) {
+            for (int f = 0; f < 3; f++) {
+                palette.setPalette(types[t], formats[f]);
+                for (size_t size = 1; size <= 100; size++)
+                    same = same && sameOutput(palette, kernels[k], frames, size);
+                same = same && sameOutput(palette, kernels[k], frames, FRAME_SIZE);
+                if (!same) {
+                    cerr << kernels[k] << " differs from scalar with the " << types[t] << " "
+                         << formats[f] << " palette" << endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    palette.setPalette("standard", "NTSC");
+    vector<uInt8> rgb(3 * FRAME_SIZE), grayscale(FRAME_SIZE);
+    cout << "us per 210x160 frame over " << num_frames << " frames" << endl;
+    cout << "kernel\tRGB\tgrayscale" << endl;
+    for (int k = 0; k < 3; k++) {
+        if (!palette.setKernels(kernels[k])) {
+            cout << kernels[k] << "\tnot supported by this CPU" << endl;
+            continue;
+        }
+
+        clock_t start = clock();
+        for (int i = 0; i < num_frames; i++)
+            palette.applyPaletteRGB(&rgb[0], &frames[(i % 8) * FRAME_SIZE], FRAME_SIZE);
+        clock_t middle = clock();
+        for (int i = 0; i < num_frames; i++)
+            palette.applyPaletteGrayscale(&grayscale[0], &frames[(i % 8) * FRAME_SIZE], FRAME_SIZE);
+        clock_t end = clock();
+
+        printf("%s\t%.1f\t%.1f\n", kernels[k], 1e6 * (middle - start) / CLOCKS_PER_SEC / num_frames,
+               1e6 * (end - middle) / CLOCKS_PER_SEC / num_frames);
+    }
+
+    return 0;
+}
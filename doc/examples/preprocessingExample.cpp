@@ -0,0 +1,144 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  preprocessingExample.cpp
+ *
+ *  Checks the native screen preprocessing against the same pipeline written
+ *  out plainly from getScreenGrayscale(): the maximum of the last two frames,
+ *  then an area-averaging resize. Without resizing the two must be identical;
+ *  with it, the native pipeline sums in single precision, so pixels may be off
+ *  by one where a value rounds half way. The frame stack must hold the last
+ *  preprocessed screens, oldest first.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <ale_interface.hpp>
+
+using namespace std;
+
+// Resizes a grayscale screen by averaging the source pixels each output pixel covers
+static vector<unsigned char> resize(const vector<unsigned char>& src, int src_height,
+                                    int src_width, int height, int width) {
+    vector<unsigned char> out(height * width);
+    double row_scale = (double)src_height / height, column_scale = (double)src_width / width;
+    for (int r = 0; r < height; r++) {
+        double top = r * row_scale, bottom = min((r + 1) * row_scale, (double)src_height);
+        for (int c = 0; c < width; c++) {
+            double left = c * column_scale, right = min((c + 1) * column_scale, (double)src_width);
+            double sum = 0;
+            for (int y = (int)top; y < bottom; y++) {
+                double height_overlap = min(y + 1.0, bottom) - max((double)y, top);
+                for (int x = (int)left; x < right; x++) {
+                    double width_overlap = min(x + 1.0, right) - max((double)x, left);
+                    sum += height_overlap * width_overlap * src[y * src_width + x];
+                }
+            }
+            double value = floor(sum / ((bottom - top) * (right - left)) + 0.5);
+            out[r * width + c] = (unsigned char)min(value, 255.0);
+        }
+    }
+    return out;
+}
+
+// Steps an interface preprocessing to height x width and compares every screen with the
+//  plain pipeline; returns the number of mismatching steps
+static int compare(const char* rom_file, int height, int width, bool max_pool) {
+    const int depth = 4;
+    ALEInterface ale;
+    ale.setInt("random_seed", 123);
+    ale.setInt("max_num_frames_per_episode", 3000);
+    ale.setInt("preprocess_height", height);
+    ale.setInt("preprocess_width", width);
+    ale.setBool("preprocess_max_pool", max_pool);
+    ale.setInt("frame_stack", depth);
+    ale.loadROM(rom_file);
+
+    ActionVect legal_actions = ale.getLegalActionSet();
+    int src_height = ale.getScreen().height(), src_width = ale.getScreen().width();
+    height = ale.getPreprocessedHeight();
+    width = ale.getPreprocessedWidth();
+    size_t size = height * width;
+    bool resized = height != src_height || width != src_width;
+
+    vector<unsigned char> previous, current, pooled, native, stack, previous_stack;
+    int mismatches = 0, steps = 0, off_by_one = 0;
+    bool fresh = true;
+
+    srand(123);
+    for (int episode = 0; episode < 2; episode++) {
+        while (!ale.game_over()) {
+            ale.act(legal_actions[rand() % legal_actions.size()]);
+            ale.getScreenGrayscale(current);
+            ale.getScreenPreprocessed(native);
+            const unsigned char* frames = ale.getFrameStack();
+            stack.assign(frames, frames + depth * size);
+
+            // The frame before the first one of an episode was not seen
+            if (!fresh) {
+                pooled = current;
+                if (max_pool) {
+                    for (size_t i = 0; i < pooled.size(); i++)
+                        pooled[i] = max(current[i], previous[i]);
+                }
+                vector<unsigned char> expected =
+                    resized ? resize(pooled, src_height, src_width, height, width) : pooled;
+
+                bool same = true;
+                for (size_t i = 0; i < size; i++) {
+                    int difference = abs((int)native[i] - (int)expected[i]);
+                    off_by_one += difference == 1;
+                    same = same && (difference == 0 || (resized && difference == 1));
+                }
+
+                // The newest frame of the stack is the screen, and the others move down by one
+                same = same && equal(native.begin(), native.end(), stack.begin() + (depth - 1) * size);
+                same = same && equal(previous_stack.begin() + size, previous_stack.end(), stack.begin());
+
+                if (!same) {
+                    if (mismatches == 0)
+                        cerr << height << "x" << width << ": episode " << episode
+                             << " differs at frame " << ale.getEpisodeFrameNumber() << endl;
+                    mismatches++;
+                }
+            }
+            previous = current;
+            previous_stack = stack;
+            fresh = false;
+            steps++;
+        }
+        ale.reset_game();
+        fresh = true;
+    }
+
+    cout << height << "x" << width << (max_pool ? ", max-pooled: " : ": ") << steps << " steps, "
+         << mismatches << " mismatches, " << off_by_one << " pixels off by one" << endl;
+    return mismatches;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+        return 1;
+    }
+
+    int mismatches = 0;
+    mismatches += compare(argv[1], 0, 0, false);
+    mismatches += compare(argv[1], 0, 0, true);
+    mismatches += compare(argv[1], 84, 84, true);
+    mismatches += compare(argv[1], 105, 80, false);
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  soundBenchmarkExample.cpp
+ *
+ *  Checks that TIASound generates the same samples a batch at a time as one
+ *  at a time, mono and stereo, for random sequences of register writes, volumes
+ *  and buffer sizes, then times both ways. Given a ROM, it also times act()
+ *  with the audio path disconnected against recording sound to a WAV file.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <ale_interface.hpp>
+#include <emucore/TIASnd.hxx>
+
+using namespace std;
+
+static const int NUM_BATCHES = 200000;
+static const uInt32 MAX_SAMPLES = 512;
+
+// Feeds sound the same random writes and buffer sizes for a given seed, and calls check with
+//  each buffer it fills; returns the time spent generating samples, in seconds
+template<class Check>
+static double generate(TIASound& sound, unsigned int seed, Check check) {
+    vector<uInt8> buffer(2 * MAX_SAMPLES);
+    clock_t generating = 0;
+    for (int i = 0; i < NUM_BATCHES; i++) {
+        // A write to AUDC0 through AUDV1 between most batches, and now and then a new volume
+        if (rand_r(&seed) % 4 != 0)
+            sound.set(0x15 + rand_r(&seed) % 6, rand_r(&seed) % 256);
+        if (rand_r(&seed) % 1000 == 0) {
+            sound.volume(rand_r(&seed) % 101);
+            sound.clipVolume(rand_r(&seed) % 2 == 0);
+        }
+        uInt32 samples = 1 + rand_r(&seed) % MAX_SAMPLES;
+
+        clock_t start = clock();
+        sound.process(&buffer[0], samples);
+        generating += clock() - start;
+        check(i, &buffer[0], samples);
+    }
+    return (double)generating / CLOCKS_PER_SEC;
+}
+
+// Keeps the samples of one run to compare the other run with
+struct Record {
+    vector<vector<uInt8> >* batches;
+    uInt32 channels;
+    void operator()(int i, const uInt8* buffer, uInt32 samples) {
+        (*batches)[i].assign(buffer, buffer + samples * channels);
+    }
+};
+
+struct Compare {
+    const vector<vector<uInt8> >* batches;
+    uInt32 channels;
+    int* mismatches;
+    void operator()(int i, const uInt8* buffer, uInt32 samples) {
+        if (vector<uInt8>(buffer, buffer + samples * channels) != (*batches)[i])
+            (*mismatches)++;
+    }
+};
+
+struct Ignore {
+    void operator()(int, const uInt8*, uInt32) {}
+};
+
+// Returns the time per act() in microseconds
+static double timeSteps(const char* rom_file, const string& sound_file, int num_steps) {
+    ALEInterface ale;
+    ale.setInt("random_seed", 123);
+    ale.setString("record_sound_filename", sound_file);
+    ale.loadROM(rom_file);
+
+    ActionVect legal_actions = ale.getLegalActionSet();
+    srand(123);
+    clock_t start = clock();
+    for (int step = 0; step < num_steps; step++) {
+        if (ale.game_over())
+            ale.reset_game();
+        ale.act(legal_actions[rand() % legal_actions.size()]);
+    }
+    return 1e6 * (clock() - start) / CLOCKS_PER_SEC / num_steps;
+}
+
+int main(int argc, char** argv) {
+    int mismatches = 0;
+    for (uInt32 channels = 1; channels <= 2; channels++) {
+        TIASound batch(31400, 31400, channels), per_sample(31400, 31400, channels);
+        per_sample.batchProcessing(false);
+
+        vector<vector<uInt8> > batches(NUM_BATCHES);
+        Record record = { &batches, channels };
+        Compare compare = { &batches, channels, &mismatches };
+        generate(per_sample, channels, record);
+        generate(batch, channels, compare);
+    }
+    cout << NUM_BATCHES << " random batches, mono and stereo: " << mismatches
+         << " differ between batch and per-sample generation" << endl;
+
+    TIASound sound;
+    sound.batchProcessing(false);
+    double per_sample_time = generate(sound, 1, Ignore());
+    sound.reset();
+    sound.batchProcessing(true);
+    double batch_time = generate(sound, 1, Ignore());
+    printf("Mono samples generated one at a time in %.2f s, in batches in %.2f s\n",
+           per_sample_time, batch_time);
+
+    if (argc > 1) {
+        string sound_file = (getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp") + string("/ale-sound.wav");
+        // The two are timed in turn, keeping the best of each, so that warming up favours neither
+        double disconnected = 1e9, recording = 1e9;
+        for (int round = 0; round < 5; round++) {
+            disconnected = min(disconnected, timeSteps(argv[1], "", 4000));
+            recording = min(recording, timeSteps(argv[1], sound_file, 4000));
+        }
+        remove(sound_file.c_str());
+        printf("act(): %.1f us with the audio path disconnected, %.1f us recording sound\n",
+               disconnected, recording);
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  threadStressExample.cpp
+ *
+ *  Checks that separate ALEInterface instances share no mutable state: 64
+ *  instances, each with its own seed and actions, are created and stepped on
+ *  64 threads at once, then one after another on a single thread. Rewards,
+ *  RAM, screens and state hashes must be identical after every step.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ale_interface.hpp>
+
+using namespace std;
+
+// What an instance looked like after one step
+struct Step {
+    reward_t reward;
+    ALERAM ram;
+    uint64_t screen_hash;
+    uint64_t state_hash;
+};
+
+// Creates instance number index and steps it, recording every step into trace
+static void run(const char* rom_file, int index, int num_steps, vector<Step>* trace) {
+    ALEInterface ale;
+    ale.setInt("random_seed", index + 1);
+    ale.setInt("max_num_frames_per_episode", 2000);
+    ale.loadROM(rom_file);
+
+    ActionVect legal_actions = ale.getLegalActionSet();
+    unsigned int actions_seed = index;
+    trace->resize(num_steps);
+    for (int i = 0; i < num_steps; i++) {
+        if (ale.game_over())
+            ale.reset_game();
+        Step& step = (*trace)[i];
+        step.reward = ale.act(legal_actions[rand_r(&actions_seed) % legal_actions.size()]);
+        step.ram = ale.getRAM();
+        step.state_hash = ale.stateHash();
+
+        const ALEScreen& screen = ale.getScreen();
+        step.screen_hash = 14695981039346656037ULL;
+        for (size_t p = 0; p < screen.arraySize(); p++)
+            step.screen_hash = (step.screen_hash ^ screen.getArray()[p]) * 1099511628211ULL;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " rom_file [num_instances] [num_steps]" << std::endl;
+        return 1;
+    }
+    int num_instances = argc > 2 ? atoi(argv[2]) : 64;
+    int num_steps = argc > 3 ? atoi(argv[3]) : 1000;
+
+    vector<vector<Step> > serial(num_instances), concurrent(num_instances);
+    for (int i = 0; i < num_instances; i++)
+        run(argv[1], i, num_steps, &serial[i]);
+
+    vector<thread> threads;
+    for (int i = 0; i < num_instances; i++)
+        threads.push_back(thread(run, argv[1], i, num_steps, &concurrent[i]));
+    for (int i = 0; i < num_instances; i++)
+        threads[i].join();
+
+    int mismatches = 0;
+    for (int i = 0; i < num_instances; i++) {
+        for (int s = 0; s < num_steps; s++) {
+            const Step& a = serial[i][s];
+            const Step& b = concurrent[i][s];
+            if (a.reward != b.reward || !a.ram.equals(b.ram) ||
+                a.screen_hash != b.screen_hash || a.state_hash != b.state_hash) {
+                cerr << "Instance " << i << " differs at step " << s << endl;
+                mismatches++;
+                break;
+            }
+        }
+    }
+
+    cout << num_instances << " instances, " << num_steps << " steps each: " << mismatches
+         << " differ between the threaded and the serial runs" << endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_episode.cpp
+ *
+ *  Recording of episodes as their initial state and action stream, and their
+ *  exact replay.
+ **************************************************************************** */
+#include "ale_episode.hpp"
+#include "environment/ale_state_codec.hpp"
+#include "emucore/Console.hxx"
+#include "emucore/Props.hxx"
+#include "emucore/Deserializer.hxx"
+#include "emucore/Serializer.hxx"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+static const std::string EPISODE_MAGIC = "ALEEpisode";
+static const int EPISODE_VERSION = 1;
+
+// Floats are stored through their bit pattern, which compares exactly
+static int floatBits(float value) {
+  int bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static std::string cartridgeMD5(ALEInterface& ale) {
+  return ale.theOSystem->console().properties().get(Cartridge_MD5);
+}
+
+/** Stores a keyframe of the current state along with the actions it would repeat */
+static void addKeyframe(ALEInterface& ale, std::vector<ALEState>& keyframes,
+                        std::string& last_actions) {
+  keyframes.push_back(ale.cloneSystemState());
+
+  Action player_a_action, player_b_action;
+  ale.environment->getLastActions(player_a_action, player_b_action);
+  last_actions += (char)player_a_action;
+  last_actions += (char)player_b_action;
+}
+
+ALEEpisodeRecorder::ALEEpisodeRecorder(ALEInterface& ale, int keyframe_interval):
+  m_ale(ale),
+  m_keyframe_interval(keyframe_interval) {
+  if (keyframe_interval < 1)
+    throw new std::runtime_error("The keyframe interval must be at least 1.");
+
+  m_md5 = cartridgeMD5(ale);
+  m_random_seed = ale.getInt("random_seed");
+  m_frame_skip = ale.getInt("frame_skip");
+  m_repeat_action_probability = ale.getFloat("repeat_action_probability");
+
+  // The first keyframe is the start of the episode
+  addKeyframe(ale, m_keyframes, m_last_actions);
+}
+
+reward_t ALEEpisodeRecorder::act(Action action) {
+  if (action < 0 || action > 0xff)
+    throw new std::runtime_error("Cannot record an action which does not fit in a byte.");
+
+  if (!m_actions.empty() && m_actions.size() % m_keyframe_interval == 0)
+    addKeyframe(m_ale, m_keyframes, m_last_actions);
+
+  m_actions += (char)action;
+  return m_ale.act(action);
+}
+
+void ALEEpisodeRecorder::save(const std::string& filename) const {
+  // Keyframes are much alike, so they are stored as one block
+  std::vector<const ALEState*> keyframes;
+  for (size_t i = 0; i < m_keyframes.size(); i++)
+    keyframes.push_back(&m_keyframes[i]);
+  std::string block;
+  ALEStateCodec::encode(&keyframes[0], keyframes.size(), block);
+
+  Serializer ser;
+  ser.putString(EPISODE_MAGIC);
+  ser.putInt(EPISODE_VERSION);
+  ser.putString(m_md5);
+  ser.putInt(m_random_seed);
+  ser.putInt(m_frame_skip);
+  ser.putInt(floatBits(m_repeat_action_probability));
+  ser.putInt(m_keyframe_interval);
+  ser.putString(m_actions);
+  ser.putString(m_last_actions);
+  ser.putString(block);
+
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  const std::string& data = ser.get_str();
+  out.write(data.data(), data.length());
+  if (!out)
+    throw new std::runtime_error("Cannot write the episode " + filename + ".");
+}
+
+ALEEpisodePlayer::ALEEpisodePlayer(ALEInterface& ale, const std::string& filename):
+  m_ale(ale),
+  m_step(-1) {
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  if (!in)
+    throw new std::runtime_error("Cannot read the episode " + filename + ".");
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  std::string md5, block;
+  int frame_skip, repeat_action_probability;
+  try {
+    Deserializer des(data);
+    if (des.getString() != EPISODE_MAGIC || des.getInt() != EPISODE_VERSION)
+      throw new std::runtime_error(filename + " is not an episode recording.");
+
+    md5 = des.getString();
+    m_random_seed = des.getInt();
+    frame_skip = des.getInt();
+    repeat_action_probability = des.getInt();
+    m_keyframe_interval = des.getInt();
+    m_actions = des.getString();
+    m_last_actions = des.getString();
+    block = des.getString();
+  }
+  catch (const char*) {
+    throw new std::runtime_error("The episode " + filename + " is truncated.");
+  }
+
+  // Any difference in these would make the replay diverge from the recording
+  if (md5 != cartridgeMD5(ale))
+    throw new std::runtime_error("The episode " + filename + " was recorded with another ROM.");
+  if (frame_skip != ale.getInt("frame_skip") ||
+      repeat_action_probability != floatBits(ale.getFloat("repeat_action_probability")))
+    throw new std::runtime_error("The episode " + filename + " was recorded with different "
+        "frame_skip or repeat_action_probability settings.");
+
+  ALEStateCodec::decode(block.data(), block.length(), m_keyframes);
+  if (m_keyframe_interval < 1 || m_keyframes.empty() ||
+      m_last_actions.length() != 2 * m_keyframes.size() ||
+      (int)m_keyframes.size() <= ((int)m_actions.size() - 1) / m_keyframe_interval)
+    throw new std::runtime_error("The episode " + filename + " is corrupt.");
+
+  seek(0);
+}
+
+void ALEEpisodePlayer::seek(int step) {
+  if (step < 0 || step > getNumSteps())
+    throw new std::runtime_error("Attempting to seek outside of the episode.");
+
+  // Playing on is cheaper than going back to the keyframe unless there is a later one
+  int keyframe = std::min(step / m_keyframe_interval, (int)m_keyframes.size() - 1);
+  if (step < m_step || keyframe * m_keyframe_interval > m_step) {
+    m_ale.restoreSystemState(m_keyframes[keyframe]);
+    m_ale.environment->setLastActions((Action)(unsigned char)m_last_actions[2 * keyframe],
+                                      (Action)(unsigned char)m_last_actions[2 * keyframe + 1]);
+    m_step = keyframe * m_keyframe_interval;
+  }
+
+  while (m_step < step)
+    this->step();
+}
+
+reward_t ALEEpisodePlayer::step() {
+  if (done())
+    throw new std::runtime_error("Attempting to play past the end of the episode.");
+
+  return m_ale.act(getAction(m_step++));
+}
@@ -0,0 +1,110 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_episode.hpp
+ *
+ *  Recording of episodes as their initial state and action stream, and their
+ *  exact replay.
+ **************************************************************************** */
+#ifndef __ALE_EPISODE_HPP__
+#define __ALE_EPISODE_HPP__
+
+#include "ale_interface.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+   Records an episode played through an ALEInterface. The recording holds
+   the system state the episode starts from, one byte per action, and a
+   keyframe of the system state every keyframe_interval steps, so that an
+   ALEEpisodePlayer can replay the episode exactly and seek within it. A step
+   is one call to act(), whatever the frame_skip setting.
+
+   System states include the random number generator, and each keyframe is
+   stored with the actions sticky actions would repeat, so replays are exact
+   with repeat_action_probability > 0 as well. They require the same ROM,
+   frame_skip and repeat_action_probability as the recording; the player
+   checks these.
+ */
+class ALEEpisodeRecorder {
+public:
+  // Starts recording from the current state of ale, which should be the
+  // start of an episode. All actions must then go through act().
+  ALEEpisodeRecorder(ALEInterface& ale, int keyframe_interval = 1000);
+
+  // Applies the action to the environment, records it and returns the
+  // reward.
+  reward_t act(Action action);
+
+  // Returns the number of steps recorded so far.
+  int getNumSteps() const { return (int)m_actions.size(); }
+
+  // Writes the recording to a file.
+  void save(const std::string& filename) const;
+
+private:
+  ALEInterface& m_ale;
+  int m_keyframe_interval;
+  std::string m_md5;
+  int m_random_seed;
+  int m_frame_skip;
+  float m_repeat_action_probability;
+  std::string m_actions;
+  std::vector<ALEState> m_keyframes; // The state before every keyframe_interval-th step
+  std::string m_last_actions; // The last actions of both players at each keyframe
+};
+
+/**
+   Replays an episode written by ALEEpisodeRecorder into an ALEInterface
+   which has loaded the same ROM with the same settings.
+ */
+class ALEEpisodePlayer {
+public:
+  // Reads the recording and brings ale to the start of the episode.
+  ALEEpisodePlayer(ALEInterface& ale, const std::string& filename);
+
+  // Returns the number of steps in the episode.
+  int getNumSteps() const { return (int)m_actions.size(); }
+
+  // Returns the random_seed setting the episode was recorded with. The
+  // replay does not depend on it, as keyframes restore the generator.
+  int getRandomSeed() const { return m_random_seed; }
+
+  // Returns the action taken at the given step.
+  Action getAction(int step) const { return (Action)(unsigned char)m_actions[step]; }
+
+  // Returns the number of steps played so far, the step the environment is
+  // at.
+  int getStep() const { return m_step; }
+
+  // Brings the environment to the state after the given number of steps, by
+  // restoring the last keyframe before it and playing forward from there.
+  // Seeking forward within the same keyframe interval plays on from the
+  // current step instead.
+  void seek(int step);
+
+  // Plays the next step of the episode and returns its reward.
+  reward_t step();
+
+  // Returns true once every step of the episode has been played.
+  bool done() const { return m_step == getNumSteps(); }
+
+private:
+  ALEInterface& m_ale;
+  int m_keyframe_interval;
+  int m_step;
+  int m_random_seed;
+  std::string m_actions;
+  std::vector<ALEState> m_keyframes;
+  std::string m_last_actions;
+};
+
+#endif
@@ -38,6 +38,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <iterator>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -60,12 +61,17 @@ std::string ALEInterface::welcomeMessage() {
 }
 
 void ALEInterface::disableBufferedIO() {
-  setvbuf(stdout, NULL, _IONBF, 0);
-  setvbuf(stdin, NULL, _IONBF, 0);
-  std::cin.rdbuf()->pubsetbuf(0, 0);
-  std::cout.rdbuf()->pubsetbuf(0, 0);
-  std::cin.sync_with_stdio();
-  std::cout.sync_with_stdio();
+  // The standard streams are shared by the whole process; only reconfigure
+  // them once, so that interfaces can be created concurrently
+  static std::once_flag disabled;
+  std::call_once(disabled, [] {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stdin, NULL, _IONBF, 0);
+    std::cin.rdbuf()->pubsetbuf(0, 0);
+    std::cout.rdbuf()->pubsetbuf(0, 0);
+    std::cin.sync_with_stdio();
+    std::cout.sync_with_stdio();
+  });
 }
 
 void ALEInterface::createOSystem(std::unique_ptr<OSystem> &theOSystem,
@@ -362,6 +368,46 @@ void ALEInterface::getScreenRGB(std::vector<unsigned char>& output_rgb_buffer) {
   theOSystem->colourPalette().applyPaletteRGB(output_rgb_buffer, ale_screen_data, screen_size);
 }
 
+// Fills the vector with the preprocessed screen.
+void ALEInterface::getScreenPreprocessed(std::vector<unsigned char>& output_buffer) {
+  ScreenPreprocessor& preprocessor = environment->getScreenPreprocessor();
+  output_buffer.resize(preprocessor.height() * preprocessor.width());
+  preprocessor.process(&output_buffer[0]);
+}
+
+int ALEInterface::getPreprocessedHeight() {
+  return environment->getScreenPreprocessor().height();
+}
+
+int ALEInterface::getPreprocessedWidth() {
+  return environment->getScreenPreprocessor().width();
+}
+
+// Returns the last few preprocessed screens, oldest first.
+const unsigned char* ALEInterface::getFrameStack() {
+  const FrameStack& stack = environment->getFrameStack();
+  return stack.enabled() ? stack.data() : NULL;
+}
+
+void ALEInterface::getFrameStack(const unsigned char** frames) {
+  const FrameStack& stack = environment->getFrameStack();
+  for (size_t i = 0; i < stack.depth(); i++)
+    frames[i] = stack.data() + i * stack.frameSize();
+}
+
+int ALEInterface::getFrameStackDepth() {
+  return environment->getFrameStack().depth();
+}
+
+// Registers a caller-owned buffer which receives the screen after every
+// act() and reset_game().
+void ALEInterface::setScreenBuffer(pixel_t* buffer, ScreenFormat format) {
+  if (!environment.get()) {
+    throw std::runtime_error("ROM not set");
+  }
+  environment->setScreenBuffer(buffer, format);
+}
+
 // Returns the current RAM content
 const ALERAM& ALEInterface::getRAM() {
   return environment->getRAM();
@@ -381,10 +427,22 @@ ALEState ALEInterface::cloneState() {
   return environment->cloneState();
 }
 
+void ALEInterface::cloneState(ALEState& state) {
+  environment->cloneState(state);
+}
+
 void ALEInterface::restoreState(const ALEState& state) {
   return environment->restoreState(state);
 }
 
+ALEState ALEInterface::cloneDeltaState(const ALEState& base) {
+  return environment->cloneDeltaState(base);
+}
+
+uint64_t ALEInterface::stateHash() {
+  return environment->stateHash();
+}
+
 ALEState ALEInterface::cloneSystemState() {
   return environment->cloneSystemState();
 }
@@ -393,6 +451,18 @@ void ALEInterface::restoreSystemState(const ALEState& state) {
   return environment->restoreSystemState(state);
 }
 
+void ALEInterface::restoreState(ALEStateStore& store, size_t index) {
+  size_t size;
+  const char* serialized = store.get(index, size);
+  environment->restoreState(serialized, size);
+}
+
+void ALEInterface::restoreSystemState(ALEStateStore& store, size_t index) {
+  size_t size;
+  const char* serialized = store.get(index, size);
+  environment->restoreSystemState(serialized, size);
+}
+
 void ALEInterface::saveScreenPNG(const std::string& filename) {
   ScreenExporter exporter(theOSystem->colourPalette());
   exporter.save(environment->getScreen(), filename);
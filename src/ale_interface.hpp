@@ -39,6 +39,7 @@
 #include "games/Roms.hpp"
 #include "common/display_screen.h"
 #include "environment/stella_environment.hpp"
+#include "environment/ale_state_store.hpp"
 #include "common/ScreenExporter.hpp"
 #include "common/Log.hpp"
 
@@ -49,6 +50,12 @@ static const std::string Version = "0.6.0";
 
 /**
    This class interfaces ALE with external code for controlling agents.
+
+   Separate ALEInterface objects share no mutable state and may be created and
+   used concurrently from different threads; a single object must not be used
+   from two threads at once. The only process-wide settings are the logging
+   verbosity (ale::Logger::setMode) and the stdio buffering disabled on
+   construction. doc/examples/threadStressExample.cpp checks this.
  */
 class ALEInterface {
 public:
@@ -143,6 +150,31 @@ public:
   //followed by the green colours and then the blue colours
   void getScreenRGB(std::vector<unsigned char>& output_rgb_buffer);
 
+  // Fills the vector with the preprocessed screen: grayscale, max-pooled over the last two
+  // frames and resized according to the preprocess_max_pool, preprocess_height and
+  // preprocess_width settings. Its dimensions are given by getPreprocessedHeight() and
+  // getPreprocessedWidth().
+  void getScreenPreprocessed(std::vector<unsigned char>& output_buffer);
+  int getPreprocessedHeight();
+  int getPreprocessedWidth();
+
+  // Returns the last getFrameStackDepth() preprocessed screens, as set by the
+  // frame_stack setting, stored contiguously from oldest to newest. The stack
+  // is refilled by reset_game() and restoreState(), and the data is valid
+  // until the next call to either or to act(). Returns NULL if frame_stack is 0.
+  const unsigned char* getFrameStack();
+  // Same as above, but sets frames[i] to the i-th frame of the stack
+  void getFrameStack(const unsigned char** frames);
+  int getFrameStackDepth();
+
+  // Registers a caller-owned buffer into which the screen is written, in
+  // the given format, at the end of every act() and reset_game(). The
+  // buffer must hold width*height bytes (three times that for SCREEN_RGB, and
+  // getPreprocessedHeight()*getPreprocessedWidth() for SCREEN_PREPROCESSED)
+  // and remain valid until it is unregistered by passing NULL. This should
+  // be called only after the rom is loaded; loadROM() drops the buffer.
+  void setScreenBuffer(pixel_t* buffer, ScreenFormat format = SCREEN_PALETTE);
+
   // Returns the current RAM content
   const ALERAM &getRAM();
 
@@ -154,13 +186,33 @@ public:
 
   // This makes a copy of the environment state. This copy does *not* include pseudorandomness,
   // making it suitable for planning purposes. By contrast, see cloneSystemState.
+  // The copy is a raw snapshot of the emulator: it can be serialized, but only restored by
+  // the same build of ALE on the same kind of machine, with the same cpu setting. Restoring
+  // it anywhere else throws.
   ALEState cloneState();
 
+  // Same as above, but stores the copy into state. The storage of state is reused unless another
+  // state still shares it, so that cloning into the same states over and over does not allocate.
+  void cloneState(ALEState& state);
+
   // Reverse operation of cloneState(). This does not restore pseudorandomness, so that repeated
   // calls to restoreState() in the stochastic controls setting will not lead to the same outcomes.
   // By contrast, see restoreSystemState.
   void restoreState(const ALEState& state);
 
+  // Like cloneState(), but the copy only stores the parts of the emulator state which differ
+  // from base, a state returned by cloneState() or cloneDeltaState(), and shares the rest with
+  // it. restoreState() applies the whole chain of deltas back to the full state. This makes
+  // search trees, where each node is close to its parent, much cheaper to store. Past a
+  // bounded chain length a full copy is returned instead.
+  ALEState cloneDeltaState(const ALEState& base);
+
+  // Returns a 64-bit hash of the state cloneState() would copy, without making the copy. Equal
+  // states hash equally whatever their frame number, which makes it suitable for detecting
+  // repeated states in planners. Like cloned states, hashes are only comparable within the same
+  // build of ALE on the same kind of machine.
+  uint64_t stateHash();
+
   // This makes a copy of the system & environment state, suitable for serialization. This includes
   // pseudorandomness and so is *not* suitable for planning purposes.
   ALEState cloneSystemState();
@@ -168,6 +220,14 @@ public:
   // Reverse operation of cloneSystemState.
   void restoreSystemState(const ALEState& state);
 
+  // Restores the state at the given index of a store, reading it in place from the store's
+  // memory mapping instead of copying it into an ALEState first. The frame stack, which stored
+  // states do not carry, restarts from the restored screen.
+  void restoreState(ALEStateStore& store, size_t index);
+
+  // As above, for a store of states returned by cloneSystemState.
+  void restoreSystemState(ALEStateStore& store, size_t index);
+
   // Save the current screen as a png file
   void saveScreenPNG(const std::string& filename);
 
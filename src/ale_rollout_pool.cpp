@@ -0,0 +1,60 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_rollout_pool.cpp
+ *
+ *  Evaluation of many rollouts from a common state, spread over the worker
+ *  pool of an ALEVectorInterface.
+ **************************************************************************** */
+
+#include "ale_rollout_pool.hpp"
+
+static int defaultNumEnvironments() {
+  int num_envs = std::thread::hardware_concurrency();
+  return num_envs > 0 ? num_envs : 1;
+}
+
+ALERolloutPool::ALERolloutPool(int num_envs, int num_threads):
+  ALEVectorInterface(num_envs > 0 ? num_envs : defaultNumEnvironments(), num_threads),
+  m_next_rollout(0),
+  m_num_rollouts(0) {
+}
+
+void ALERolloutPool::evaluate(const ALEState& root, const ActionSequence* seqs, int k,
+                              reward_t* returns, uint8_t* terminals) {
+  unsigned seed = (unsigned)getInt("random_seed") + m_num_rollouts;
+
+  // Environments claim rollouts until none is left, so that short and long
+  //  rollouts even out across threads
+  m_next_rollout = 0;
+  run([this, &root, seqs, k, returns, terminals, seed](int i) {
+    ALEInterface& ale = getInterface(i);
+
+    for (int j = m_next_rollout++; j < k; j = m_next_rollout++) {
+      ale.restoreState(root);
+      ale.theOSystem->rng().seed(seed + j);
+      ale.environment->setLastActions(PLAYER_A_NOOP, PLAYER_B_NOOP);
+
+      const ActionSequence& actions = seqs[j];
+      reward_t total = 0;
+      bool terminal = ale.game_over();
+      for (size_t t = 0; t < actions.size() && !terminal; t++) {
+        total += ale.act(actions[t]);
+        terminal = ale.game_over();
+      }
+
+      returns[j] = total;
+      if (terminals != NULL)
+        terminals[j] = terminal ? 1 : 0;
+    }
+  });
+
+  m_num_rollouts += k;
+}
@@ -0,0 +1,61 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_rollout_pool.hpp
+ *
+ *  Evaluation of many rollouts from a common state, spread over the worker
+ *  pool of an ALEVectorInterface.
+ **************************************************************************** */
+#ifndef __ALE_ROLLOUT_POOL_HPP__
+#define __ALE_ROLLOUT_POOL_HPP__
+
+#include "ale_vector_interface.hpp"
+
+#include <stdint.h>
+#include <atomic>
+
+// The actions of player A during one rollout
+typedef ActionVect ActionSequence;
+
+/**
+   Plays rollouts from a root state on several environments at once, as
+   search agents do when they evaluate candidate action sequences. Each
+   environment runs on its own worker thread and plays the rollouts it claims
+   one after the other, restoring the root state before each of them.
+
+   The environments are those of the underlying ALEVectorInterface, so
+   settings and loadROM() apply to all of them as usual.
+ */
+class ALERolloutPool : public ALEVectorInterface {
+public:
+  // Creates num_envs environments, one per hardware thread if num_envs is
+  // 0. num_threads is as for ALEVectorInterface.
+  ALERolloutPool(int num_envs = 0, int num_threads = 0);
+
+  // Plays the k rollouts seqs[0..k-1], each from root, which must have been
+  // returned by cloneState() on an environment running the same ROM. A
+  // rollout stops early if the game ends. returns[j] receives the sum of the
+  // rewards of rollout j and, if terminals is not NULL, terminals[j] whether
+  // the game ended during it.
+  //
+  // Before each rollout, the random number generator of its environment is
+  // seeded from random_seed and the number of rollouts played so far, and the
+  // previous action taken as a noop. The results of a call therefore do not
+  // depend on how rollouts are spread over threads, while successive calls
+  // still draw different sticky actions when repeat_action_probability > 0.
+  void evaluate(const ALEState& root, const ActionSequence* seqs, int k,
+                reward_t* returns, uint8_t* terminals = NULL);
+
+private:
+  std::atomic<int> m_next_rollout; // The next rollout to hand out to an environment
+  unsigned m_num_rollouts; // Rollouts played by earlier calls to evaluate()
+};
+
+#endif
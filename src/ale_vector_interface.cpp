@@ -0,0 +1,189 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_vector_interface.cpp
+ *
+ *  An interface which owns several environments and steps them together on a
+ *  pool of worker threads.
+ **************************************************************************** */
+
+#include "ale_vector_interface.hpp"
+
+#include <ctime>
+#include <stdexcept>
+
+ALEVectorInterface::ALEVectorInterface(int num_envs, int num_threads):
+  m_num_envs(num_envs),
+  m_screen_height(0),
+  m_screen_width(0),
+  m_next_env(0),
+  m_remaining(0),
+  m_generation(0),
+  m_shutdown(false) {
+  if (num_envs < 1) {
+    throw std::runtime_error("ALEVectorInterface needs at least one environment");
+  }
+
+  for (int i = 0; i < m_num_envs; i++) {
+    m_envs.push_back(std::unique_ptr<ALEInterface>(new ALEInterface()));
+  }
+
+  if (num_threads <= 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (num_threads > m_num_envs) {
+    num_threads = m_num_envs;
+  }
+
+  // With a single worker there is nothing to gain from a separate thread
+  if (num_threads > 1) {
+    for (int t = 0; t < num_threads; t++) {
+      m_workers.push_back(std::thread(&ALEVectorInterface::workerLoop, this));
+    }
+  }
+}
+
+ALEVectorInterface::~ALEVectorInterface() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_work_cv.notify_all();
+
+  for (size_t t = 0; t < m_workers.size(); t++) {
+    m_workers[t].join();
+  }
+}
+
+// Get the value of a setting.
+std::string ALEVectorInterface::getString(const std::string& key) {
+  return m_envs[0]->getString(key);
+}
+int ALEVectorInterface::getInt(const std::string& key) {
+  return m_envs[0]->getInt(key);
+}
+bool ALEVectorInterface::getBool(const std::string& key) {
+  return m_envs[0]->getBool(key);
+}
+float ALEVectorInterface::getFloat(const std::string& key) {
+  return m_envs[0]->getFloat(key);
+}
+
+// Set the value of a setting.
+void ALEVectorInterface::setString(const std::string& key, const std::string& value) {
+  for (int i = 0; i < m_num_envs; i++) m_envs[i]->setString(key, value);
+}
+void ALEVectorInterface::setInt(const std::string& key, const int value) {
+  for (int i = 0; i < m_num_envs; i++) m_envs[i]->setInt(key, value);
+}
+void ALEVectorInterface::setBool(const std::string& key, const bool value) {
+  for (int i = 0; i < m_num_envs; i++) m_envs[i]->setBool(key, value);
+}
+void ALEVectorInterface::setFloat(const std::string& key, const float value) {
+  for (int i = 0; i < m_num_envs; i++) m_envs[i]->setFloat(key, value);
+}
+
+void ALEVectorInterface::loadROM(std::string rom_file) {
+  int seed = getInt("random_seed");
+  if (seed == 0) {
+    seed = (int)time(NULL);
+  }
+
+  // ROMs are loaded one at a time; only stepping happens on the workers
+  for (int i = 0; i < m_num_envs; i++) {
+    m_envs[i]->setInt("random_seed", seed + i);
+    m_envs[i]->loadROM(rom_file);
+  }
+  setInt("random_seed", seed);
+
+  m_screen_height = m_envs[0]->getScreen().height();
+  m_screen_width = m_envs[0]->getScreen().width();
+  m_screens.resize(m_num_envs * m_screen_height * m_screen_width);
+
+  // Each environment writes its screen straight into its slice of m_screens
+  for (int i = 0; i < m_num_envs; i++) {
+    m_envs[i]->setScreenBuffer(&m_screens[i * m_screen_height * m_screen_width]);
+  }
+}
+
+void ALEVectorInterface::step(const Action* actions, reward_t* rewards,
+                              uint8_t* terminals) {
+  run([this, actions, rewards, terminals](int i) {
+    ALEInterface& ale = *m_envs[i];
+
+    if (ale.game_over()) {
+      ale.reset_game();
+    }
+    rewards[i] = ale.act(actions[i]);
+    terminals[i] = ale.game_over() ? 1 : 0;
+  });
+}
+
+void ALEVectorInterface::reset_game() {
+  run([this](int i) {
+    m_envs[i]->reset_game();
+  });
+}
+
+ActionVect ALEVectorInterface::getLegalActionSet() {
+  return m_envs[0]->getLegalActionSet();
+}
+
+ActionVect ALEVectorInterface::getMinimalActionSet() {
+  return m_envs[0]->getMinimalActionSet();
+}
+
+void ALEVectorInterface::run(const std::function<void(int)>& job) {
+  if (m_workers.empty()) {
+    for (int i = 0; i < m_num_envs; i++) {
+      job(i);
+    }
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_job = job;
+  m_remaining = m_num_envs;
+  m_next_env = 0;
+  m_generation++;
+  m_work_cv.notify_all();
+
+  m_done_cv.wait(lock, [this] { return m_remaining == 0; });
+}
+
+void ALEVectorInterface::workerLoop() {
+  unsigned seen_generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_work_cv.wait(lock, [this, seen_generation] {
+        return m_shutdown || m_generation != seen_generation;
+      });
+      if (m_shutdown) return;
+      seen_generation = m_generation;
+    }
+
+    // Claim environments until every one of them has been handed out
+    int completed = 0;
+    for (int i = m_next_env++; i < m_num_envs; i = m_next_env++) {
+      m_job(i);
+      completed++;
+    }
+
+    if (completed > 0) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_remaining -= completed;
+      if (m_remaining == 0) {
+        m_done_cv.notify_one();
+      }
+    }
+  }
+}
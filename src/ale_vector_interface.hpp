@@ -0,0 +1,126 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_vector_interface.hpp
+ *
+ *  An interface which owns several environments and steps them together on a
+ *  pool of worker threads.
+ **************************************************************************** */
+#ifndef __ALE_VECTOR_INTERFACE_HPP__
+#define __ALE_VECTOR_INTERFACE_HPP__
+
+#include "ale_interface.hpp"
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+   This class owns num_envs independent ALEInterface objects and steps them
+   in lockstep. Each call to step() applies one action per environment; the
+   work is spread over an internal pool of threads and the resulting screens
+   are written into a single contiguous (num_envs x height x width) buffer.
+ */
+class ALEVectorInterface {
+public:
+  // Creates num_envs environments. num_threads is the number of worker
+  // threads used to step them; 0 means one per hardware thread. No threads
+  // are started when a single worker would be used.
+  ALEVectorInterface(int num_envs, int num_threads = 0);
+  ~ALEVectorInterface();
+
+  // Get the value of a setting. All environments share the same settings.
+  std::string getString(const std::string& key);
+  int getInt(const std::string& key);
+  bool getBool(const std::string& key);
+  float getFloat(const std::string& key);
+
+  // Set the value of a setting in every environment. loadROM() must be
+  // called before the setting will take effect.
+  void setString(const std::string& key, const std::string& value);
+  void setInt(const std::string& key, const int value);
+  void setBool(const std::string& key, const bool value);
+  void setFloat(const std::string& key, const float value);
+
+  // Loads the game in every environment. Environment i is seeded with
+  // random_seed + i (random_seed == 0 draws the base seed from the clock),
+  // so that the environments do not all play out the same trajectory.
+  void loadROM(std::string rom_file);
+
+  // Applies actions[i] to environment i and stores the resulting reward and
+  // terminal flag in rewards[i] and terminals[i]. Each array must hold
+  // getNumEnvironments() elements. An environment which was in a terminal
+  // state when step() is called is reset before its action is applied.
+  void step(const Action* actions, reward_t* rewards, uint8_t* terminals);
+
+  // Resets every environment.
+  void reset_game();
+
+  // Returns the number of environments.
+  int getNumEnvironments() const { return m_num_envs; }
+
+  // Returns the number of worker threads (0 if stepping happens inline).
+  int getNumThreads() const { return (int)m_workers.size(); }
+
+  // Returns the screens of all environments after the last step(), as
+  // palette indices laid out as getNumEnvironments() consecutive screens of
+  // getScreenHeight() x getScreenWidth() pixels.
+  const pixel_t* getScreens() const { return m_screens.empty() ? NULL : &m_screens[0]; }
+
+  // Dimensions of a single screen.
+  size_t getScreenHeight() const { return m_screen_height; }
+  size_t getScreenWidth() const { return m_screen_width; }
+
+  // Returns the vector of legal actions, or the minimal action set. These
+  // are the same for every environment.
+  ActionVect getLegalActionSet();
+  ActionVect getMinimalActionSet();
+
+  // Direct access to a single environment, e.g. to query lives() or clone
+  // its state. Must not be used while step() or reset_game() is running.
+  ALEInterface& getInterface(int i) { return *m_envs[i]; }
+
+ protected:
+  // Runs job(i) for every environment i, on the worker pool if there is one,
+  // and returns once all of them have completed.
+  void run(const std::function<void(int)>& job);
+
+ private:
+  // Main loop of each worker thread.
+  void workerLoop();
+
+ private:
+  int m_num_envs;
+  std::vector<std::unique_ptr<ALEInterface> > m_envs;
+
+  std::vector<pixel_t> m_screens; // Contiguous screens of all environments
+  size_t m_screen_height;
+  size_t m_screen_width;
+
+  // Worker pool. m_generation is bumped each time a new job is posted;
+  // workers then claim environments through m_next_env until none is left.
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  std::function<void(int)> m_job;
+  std::atomic<int> m_next_env;
+  int m_remaining;
+  unsigned m_generation;
+  bool m_shutdown;
+};
+
+#endif
@@ -21,6 +21,13 @@
 #include <fstream>
 #include "Palettes.hpp"
 
+// The vectorized conversion kernels are compiled for their instruction set whatever the build
+// flags, and only used after checking at runtime that the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALE_PALETTE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 inline uInt32 packRGB(uInt8 r, uInt8 g, uInt8 b)
@@ -40,6 +47,7 @@ inline uInt32 convertGrayscale(uInt32 packedRGBValue)
 }
 
 ColourPalette::ColourPalette(): m_palette(NULL) {
+    setKernels("auto");
 }
 
 
@@ -71,42 +79,181 @@ uInt32 ColourPalette::getRGB(int val) const
     return m_palette[val];
 }
 
-void ColourPalette::applyPaletteRGB(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
+typedef void (*PaletteKernel)(uInt8* dst_buffer, const uInt8* src_buffer, size_t src_size,
+    const uInt32* palette);
+
+static void applyPaletteRGBScalar(uInt8* dst_buffer, const uInt8* src_buffer, size_t src_size,
+    const uInt32* palette)
 {
-    uInt8 *p = src_buffer;
+    const uInt8 *p = src_buffer;
     uInt8 *q = dst_buffer;
 
     for(size_t i = 0; i < src_size; i++, p++){
-        int rgb = m_palette[*p];
+        int rgb = palette[*p];
         *q = (unsigned char) ((rgb >> 16));  q++;    // r
         *q = (unsigned char) ((rgb >>  8));  q++;    // g
         *q = (unsigned char) ((rgb >>  0));  q++;    // b
     }
 }
 
-void ColourPalette::applyPaletteRGB(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size)
+static void applyPaletteGrayscaleScalar(uInt8* dst_buffer, const uInt8* src_buffer,
+    size_t src_size, const uInt32* palette)
 {
-    dst_buffer.resize(3 * src_size);
-    assert(dst_buffer.size() == 3 * src_size);
+    const uInt8 *p = src_buffer;
+    uInt8 *q = dst_buffer;
 
-    uInt8 *p = src_buffer;
+    for(size_t i = 0; i < src_size; i++, p++, q++){
+        *q = (unsigned char) (palette[*p+1] & 0xFF);
+    }
+}
 
-    for(size_t i = 0; i < src_size * 3; i += 3, p++){
-        int rgb = m_palette[*p];
-        dst_buffer[i+0] = (unsigned char) ((rgb >> 16));    // r
-        dst_buffer[i+1] = (unsigned char) ((rgb >>  8));    // g
-        dst_buffer[i+2] = (unsigned char) ((rgb >>  0));    // b
+#ifdef ALE_PALETTE_X86_KERNELS
+/** Looks up 4 pixels at a time and packs their 0x00RRGGBB entries into 12 bytes of R, G, B. */
+__attribute__((target("ssse3")))
+static void applyPaletteRGBSSSE3(uInt8* dst_buffer, const uInt8* src_buffer, size_t src_size,
+    const uInt32* palette)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    // Each store writes 16 bytes, 4 more than the pixels it converts; stop while they still fit
+    size_t i = 0;
+    for(; i + 6 <= src_size; i += 4){
+        __m128i rgb = _mm_setr_epi32(palette[src_buffer[i]], palette[src_buffer[i+1]],
+                                     palette[src_buffer[i+2]], palette[src_buffer[i+3]]);
+        _mm_storeu_si128((__m128i*)(dst_buffer + 3 * i), _mm_shuffle_epi8(rgb, shuffle));
     }
+
+    applyPaletteRGBScalar(dst_buffer + 3 * i, src_buffer + i, src_size - i, palette);
 }
 
-void ColourPalette::applyPaletteGrayscale(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
+/** Gathers the palette entries of 8 pixels at a time, then packs them as for SSSE3. */
+__attribute__((target("avx2")))
+static void applyPaletteRGBAVX2(uInt8* dst_buffer, const uInt8* src_buffer, size_t src_size,
+    const uInt32* palette)
 {
-    uInt8 *p = src_buffer;
-    uInt8 *q = dst_buffer;
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    // The second store of each iteration writes 4 bytes past the converted pixels
+    size_t i = 0;
+    for(; i + 10 <= src_size; i += 8){
+        __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src_buffer + i)));
+        __m256i rgb = _mm256_shuffle_epi8(
+            _mm256_i32gather_epi32((const int*)palette, index, 4), shuffle);
+
+        _mm_storeu_si128((__m128i*)(dst_buffer + 3 * i), _mm256_castsi256_si128(rgb));
+        _mm_storeu_si128((__m128i*)(dst_buffer + 3 * i + 12), _mm256_extracti128_si256(rgb, 1));
+    }
 
-    for(size_t i = 0; i < src_size; i++, p++, q++){
-        *q = (unsigned char) (m_palette[*p+1] & 0xFF);
+    applyPaletteRGBScalar(dst_buffer + 3 * i, src_buffer + i, src_size - i, palette);
+}
+
+/** Gathers the grayscale entries of 32 pixels at a time and narrows them to bytes. */
+__attribute__((target("avx2")))
+static void applyPaletteGrayscaleAVX2(uInt8* dst_buffer, const uInt8* src_buffer,
+    size_t src_size, const uInt32* palette)
+{
+    const int* grayscale = (const int*)(palette + 1);
+    const __m256i low_byte = _mm256_set1_epi32(0xFF);
+    // Undoes the lane interleaving of the two packs below
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+    for(; i + 32 <= src_size; i += 32){
+        __m256i pixels = _mm256_loadu_si256((const __m256i*)(src_buffer + i));
+        __m128i low = _mm256_castsi256_si128(pixels);
+        __m128i high = _mm256_extracti128_si256(pixels, 1);
+
+        __m256i a = _mm256_i32gather_epi32(grayscale, _mm256_cvtepu8_epi32(low), 4);
+        __m256i b = _mm256_i32gather_epi32(grayscale,
+            _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)), 4);
+        __m256i c = _mm256_i32gather_epi32(grayscale, _mm256_cvtepu8_epi32(high), 4);
+        __m256i d = _mm256_i32gather_epi32(grayscale,
+            _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)), 4);
+
+        __m256i ab = _mm256_packus_epi32(_mm256_and_si256(a, low_byte), _mm256_and_si256(b, low_byte));
+        __m256i cd = _mm256_packus_epi32(_mm256_and_si256(c, low_byte), _mm256_and_si256(d, low_byte));
+        __m256i gray = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), order);
+
+        _mm256_storeu_si256((__m256i*)(dst_buffer + i), gray);
     }
+
+    applyPaletteGrayscaleScalar(dst_buffer + i, src_buffer + i, src_size - i, palette);
+}
+#endif
+
+/** Picks the fastest RGB kernel this CPU supports. */
+static PaletteKernel selectRGBKernel()
+{
+#ifdef ALE_PALETTE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return applyPaletteRGBAVX2;
+    if (__builtin_cpu_supports("ssse3"))
+        return applyPaletteRGBSSSE3;
+#endif
+    return applyPaletteRGBScalar;
+}
+
+/** Picks the fastest grayscale kernel this CPU supports. */
+static PaletteKernel selectGrayscaleKernel()
+{
+#ifdef ALE_PALETTE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return applyPaletteGrayscaleAVX2;
+#endif
+    return applyPaletteGrayscaleScalar;
+}
+
+bool ColourPalette::setKernels(const string& instruction_set)
+{
+    if (instruction_set == "auto") {
+        static const PaletteKernel rgb_kernel = selectRGBKernel();
+        static const PaletteKernel grayscale_kernel = selectGrayscaleKernel();
+        m_rgb_kernel = rgb_kernel;
+        m_grayscale_kernel = grayscale_kernel;
+        return true;
+    }
+    if (instruction_set == "scalar") {
+        m_rgb_kernel = applyPaletteRGBScalar;
+        m_grayscale_kernel = applyPaletteGrayscaleScalar;
+        return true;
+    }
+#ifdef ALE_PALETTE_X86_KERNELS
+    __builtin_cpu_init();
+    if (instruction_set == "ssse3" && __builtin_cpu_supports("ssse3")) {
+        m_rgb_kernel = applyPaletteRGBSSSE3;
+        m_grayscale_kernel = applyPaletteGrayscaleScalar;
+        return true;
+    }
+    if (instruction_set == "avx2" && __builtin_cpu_supports("avx2")) {
+        m_rgb_kernel = applyPaletteRGBAVX2;
+        m_grayscale_kernel = applyPaletteGrayscaleAVX2;
+        return true;
+    }
+#endif
+    return false;
+}
+
+void ColourPalette::applyPaletteRGB(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
+{
+    m_rgb_kernel(dst_buffer, src_buffer, src_size, m_palette);
+}
+
+void ColourPalette::applyPaletteRGB(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size)
+{
+    dst_buffer.resize(3 * src_size);
+    assert(dst_buffer.size() == 3 * src_size);
+
+    if (src_size > 0)
+        applyPaletteRGB(&dst_buffer[0], src_buffer, src_size);
+}
+
+void ColourPalette::applyPaletteGrayscale(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
+{
+    m_grayscale_kernel(dst_buffer, src_buffer, src_size, m_palette);
 }
 
 void ColourPalette::applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size)
@@ -114,11 +261,8 @@ void ColourPalette::applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer
     dst_buffer.resize(src_size);
     assert(dst_buffer.size() == src_size);
 
-    uInt8 *p = src_buffer;
-
-    for(size_t i = 0; i < src_size; i++, p++){
-        dst_buffer[i] = (unsigned char) (m_palette[*p+1] & 0xFF);
-    }
+    if (src_size > 0)
+        applyPaletteGrayscale(&dst_buffer[0], src_buffer, src_size);
 }
 
 void ColourPalette::setPalette(const string& type,
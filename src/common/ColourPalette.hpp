@@ -52,6 +52,14 @@ class ColourPalette {
         void applyPaletteGrayscale(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size);
         void applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size);
 
+        /**
+            Picks the kernels the two conversions above use: "scalar", "ssse3", "avx2", or "auto"
+            for the fastest ones this CPU supports, which is the default. There is no SSSE3
+            grayscale kernel, so "ssse3" converts to grayscale with the scalar one.
+            Returns false, leaving the kernels unchanged, if the CPU does not support the set.
+         */
+        bool setKernels(const std::string& instruction_set);
+
         /**
           Loads all defined palettes with PAL color-loss data depending
           on 'state'.
@@ -72,6 +80,10 @@ class ColourPalette {
 private:
         uInt32 *m_palette;
 
+        // The conversion kernels picked by setKernels()
+        void (*m_rgb_kernel)(uInt8*, const uInt8*, size_t, const uInt32*);
+        void (*m_grayscale_kernel)(uInt8*, const uInt8*, size_t, const uInt32*);
+
         bool myUserPaletteDefined;
 
         // Table of RGB values for NTSC, PAL and SECAM - user-defined
@@ -1,5 +1,6 @@
 #ifndef __LOG_HPP__
 #define __LOG_HPP__
+#include <atomic>
 #include <iostream>
 namespace ale
 {
@@ -14,10 +15,13 @@ namespace ale
         /** @brief Allow to change the level of verbosity 
          * @param m Info will print all the messages, Warning only the important ones 
          * and Error the critical ones
+         *
+         * The verbosity is shared by the whole process; it may be changed while
+         * other threads are logging.
          */
         static void setMode(mode m);
     private:
-        static mode current_mode;
+        static std::atomic<mode> current_mode;
         friend mode operator<<(mode,std::ostream&(*manip)(std::ostream &));
         template<typename T>
         friend mode operator<<(mode, const T&);
@@ -141,6 +141,11 @@ class SoundNull : public Sound
       */
     virtual void recordNextFrame() { }
 
+    /**
+      The null sound device neither plays nor records its samples.
+    */
+    virtual bool isConsumed() const { return false; }
+
 public:
     /**
       Loads the current state of this device from the given Deserializer.
@@ -157,6 +162,13 @@ public:
       @return The result of the save.  True on success, false on failure.
     */
     bool save(Serializer& out);
+
+    /**
+      The null sound device has no state to snapshot.
+    */
+    uInt32 snapshotSize() { return 0; }
+    void saveSnapshot(uInt8* block) { }
+    void loadSnapshot(const uInt8* block) { }
 };
 
 #endif
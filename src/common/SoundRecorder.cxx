@@ -0,0 +1,167 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *   Matthew Hausknecht and the Reinforcement Learning and Artificial Intelligence 
+ *   Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  SoundRecorder.cxx 
+ *
+ *  A sound object which records the emulated audio to a WAV file without
+ *  playing it.
+ **************************************************************************** */
+
+#include "Serializer.hxx"
+#include "Deserializer.hxx"
+
+#include "Console.hxx"
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "System.hxx"
+#include "SoundRecorder.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundRecorder::SoundRecorder(OSystem* osystem)
+  : Sound(osystem),
+    myFrameStartCycle(0),
+    myIsRecordingFrame(false),
+    myLastRegisterSetCycle(0)
+{
+  // Every TIA clock produces one sample
+  myTIASound.outputFrequency(31400);
+  myTIASound.tiaFrequency(31400);
+  myTIASound.channels(1);
+
+  std::string filename = osystem->settings().getString("record_sound_filename");
+  mySoundExporter.reset(new ale::sound::SoundExporter(filename, 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundRecorder::~SoundRecorder()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundRecorder::adjustCycleCounter(Int32 amount)
+{
+  for(uInt32 i = 0; i < myRegWrites.size(); ++i)
+    myRegWrites[i].cycle += amount;
+
+  myFrameStartCycle += amount;
+  myLastRegisterSetCycle += amount;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundRecorder::reset()
+{
+  myRegWrites.clear();
+  myTIASound.reset();
+  myLastRegisterSetCycle = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundRecorder::set(uInt16 addr, uInt8 value, Int32 cycle)
+{
+  RegWrite info;
+  info.addr = addr;
+  info.value = value;
+  info.cycle = cycle;
+  myRegWrites.push_back(info);
+
+  myLastRegisterSetCycle = cycle;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundRecorder::recordNextFrame()
+{
+  Int32 cycle = myOSystem->console().system().cycles();
+
+  if(myIsRecordingFrame)
+  {
+    processFrame(cycle);
+  }
+  else
+  {
+    // Nothing was requested since the last frame, so only the final
+    // register values matter
+    for(uInt32 i = 0; i < myRegWrites.size(); ++i)
+      myTIASound.set(myRegWrites[i].addr, myRegWrites[i].value);
+  }
+
+  myRegWrites.clear();
+  myFrameStartCycle = cycle;
+  myIsRecordingFrame = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundRecorder::processFrame(Int32 cycle)
+{
+  const uInt32 samples = ale::sound::SoundExporter::SamplesPerFrame;
+  uInt8 buffer[samples];
+
+  // Each register write takes effect at the sample matching its position
+  // within the frame
+  double frameCycles = cycle - myFrameStartCycle;
+  uInt32 position = 0;
+  for(uInt32 i = 0; i < myRegWrites.size(); ++i)
+  {
+    const RegWrite& info = myRegWrites[i];
+
+    uInt32 target = samples;
+    if(info.cycle <= myFrameStartCycle)
+      target = 0;
+    else if(info.cycle < cycle)
+      target = (uInt32)((info.cycle - myFrameStartCycle) * samples / frameCycles);
+
+    if(target > position)
+    {
+      myTIASound.process(buffer + position, target - position);
+      position = target;
+    }
+    myTIASound.set(info.addr, info.value);
+  }
+  myTIASound.process(buffer + position, samples - position);
+
+  mySoundExporter->addSamples(buffer, samples);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundRecorder::load(Deserializer& in)
+{
+  if(in.getString() != "TIASound")
+    return false;
+
+  for(uInt16 addr = 0x15; addr <= 0x1a; ++addr)
+    myTIASound.set(addr, (uInt8) in.getInt());
+
+  myLastRegisterSetCycle = (Int32) in.getInt();
+
+  // The writes of the frame being recorded belong to the replaced state,
+  // so the frame continues from the loaded cycle
+  myRegWrites.clear();
+  myFrameStartCycle = myOSystem->console().system().cycles();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundRecorder::save(Serializer& out)
+{
+  out.putString("TIASound");
+
+  // Save the registers as they are after the writes of the current frame
+  TIASound sound(myTIASound);
+  for(uInt32 i = 0; i < myRegWrites.size(); ++i)
+    sound.set(myRegWrites[i].addr, myRegWrites[i].value);
+
+  for(uInt16 addr = 0x15; addr <= 0x1a; ++addr)
+    out.putInt(sound.get(addr));
+
+  out.putInt(myLastRegisterSetCycle);
+
+  return true;
+}
@@ -0,0 +1,137 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *   Matthew Hausknecht and the Reinforcement Learning and Artificial Intelligence 
+ *   Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  SoundRecorder.hxx 
+ *
+ *  A sound object which records the emulated audio to a WAV file without
+ *  playing it.
+ **************************************************************************** */
+
+#ifndef SOUND_RECORDER_HXX
+#define SOUND_RECORDER_HXX
+
+class OSystem;
+class Serializer;
+class Deserializer;
+
+#include <memory>
+#include <vector>
+#include "../emucore/m6502/src/bspf/src/bspf.hxx"
+#include "../emucore/Sound.hxx"
+#include "../emucore/TIASnd.hxx"
+#include "SoundExporter.hpp"
+
+/**
+  This class implements a sound object which only records sound.  Unlike
+  SoundSDL it doesn't depend on an audio callback: the register writes of
+  each emulated frame are kept with their system cycle, and a frame's worth
+  of samples is generated at once when the next frame is requested.
+*/
+class SoundRecorder : public Sound
+{
+  public:
+    /**
+      Create a new sound object recording to the file given by the
+      record_sound_filename setting.
+    */
+    SoundRecorder(OSystem* osystem);
+
+    /**
+      Destructor
+    */
+    virtual ~SoundRecorder();
+
+  public: 
+    void setEnabled(bool) { }
+    void adjustCycleCounter(Int32 amount);
+    void setChannels(uInt32) { }
+    void setFrameRate(uInt32) { }
+    void initialize() { }
+    void close() { }
+    bool isSuccessfullyInitialized() const { return true; }
+    void mute(bool) { }
+    void reset();
+
+    /**
+      Sets the sound register to a given value.  The write takes effect
+      when the samples of the current frame are generated.
+
+      @param addr  The register address
+      @param value The value to save into the register
+      @param cycle The system cycle at which the register is being updated
+    */
+    void set(uInt16 addr, uInt8 value, Int32 cycle);
+
+    void setVolume(Int32) { }
+    void adjustVolume(Int8) { }
+
+    /**
+      Generates and records the samples of the frame emulated since the
+      previous call, then starts recording the next frame.
+    */
+    void recordNextFrame();
+
+  public:
+    /**
+      Loads the current state of this device from the given Deserializer.
+
+      @param in The deserializer device to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    bool load(Deserializer& in);
+
+    /**
+      Saves the current state of this device to the given Serializer.
+
+      @param out The serializer device to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    bool save(Serializer& out);
+
+  private:
+    /**
+      Generates a frame's worth of samples for the cycles from the start
+      of the frame up to the given cycle, applying the register writes at
+      their position within the frame.
+
+      @param cycle The system cycle at which the frame ends
+    */
+    void processFrame(Int32 cycle);
+
+  private:
+    // Struct to hold information regarding a TIA sound register write
+    struct RegWrite
+    {
+      uInt16 addr;
+      uInt8 value;
+      Int32 cycle;
+    };
+
+    // TIASound emulation object
+    TIASound myTIASound;
+
+    // The register writes of the current frame, in the order they happened
+    std::vector<RegWrite> myRegWrites;
+
+    // The system cycle at which the current frame started
+    Int32 myFrameStartCycle;
+
+    // Indicates if the current frame was requested to be recorded
+    bool myIsRecordingFrame;
+
+    // The system cycle of the last register write
+    Int32 myLastRegisterSetCycle;
+
+    // The file the samples are written to
+    std::unique_ptr<ale::sound::SoundExporter> mySoundExporter;
+};
+
+#endif
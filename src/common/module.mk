@@ -3,6 +3,7 @@ MODULE := src/common
 MODULE_OBJS := \
 	src/common/SoundNull.o \
 	src/common/SoundSDL.o \
+	src/common/SoundRecorder.o \
     src/common/SoundExporter.o \
 	src/common/display_screen.o \
 	src/common/ColourPalette.o \
@@ -49,6 +49,42 @@
 #include "Props.hxx"
 #include "Settings.hxx"
 using namespace std;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Accessors calling the peek() and poke() of a cartridge class directly, so that they are
+// compiled with its bank switching inlined
+template<class T>
+static uInt8 peekAs(Cartridge* cartridge, uInt16 address)
+{
+  return static_cast<T*>(cartridge)->T::peek(address);
+}
+
+template<class T>
+static void pokeAs(Cartridge* cartridge, uInt16 address, uInt8 value)
+{
+  static_cast<T*>(cartridge)->T::poke(address, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The accessors of cartridges not made by create(), through virtual dispatch
+static uInt8 peekVirtual(Cartridge* cartridge, uInt16 address)
+{
+  return cartridge->peek(address);
+}
+
+static void pokeVirtual(Cartridge* cartridge, uInt16 address, uInt8 value)
+{
+  cartridge->poke(address, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class T>
+T* Cartridge::specialize(T* cartridge)
+{
+  cartridge->myPeek = &peekAs<T>;
+  cartridge->myPoke = &pokeAs<T>;
+  return cartridge;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge* Cartridge::create(const uInt8* image, uInt32 size,
     const Properties& properties, const Settings& settings)
@@ -86,63 +122,67 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size,
     type = detected;
   }
   buf << endl;
-  myAboutString = buf.str();
 
   // We should know the cart's type by now so let's create it
   if(type == "2K")
-    cartridge = new Cartridge2K(image);
+    cartridge = specialize(new Cartridge2K(image));
   else if(type == "3E")
-    cartridge = new Cartridge3E(image, size);
+    cartridge = specialize(new Cartridge3E(image, size));
   else if(type == "3F")
-    cartridge = new Cartridge3F(image, size);
+    cartridge = specialize(new Cartridge3F(image, size));
   else if(type == "4A50")
-    cartridge = new Cartridge4A50(image);
+    cartridge = specialize(new Cartridge4A50(image));
   else if(type == "4K")
-    cartridge = new Cartridge4K(image);
+    cartridge = specialize(new Cartridge4K(image));
   else if(type == "AR")
-    cartridge = new CartridgeAR(image, size, true); //settings.getBool("fastscbios")
+    cartridge = specialize(new CartridgeAR(image, size, true)); //settings.getBool("fastscbios")
   else if(type == "DPC")
-    cartridge = new CartridgeDPC(image, size);
+    cartridge = specialize(new CartridgeDPC(image, size));
   else if(type == "E0")
-    cartridge = new CartridgeE0(image);
+    cartridge = specialize(new CartridgeE0(image));
   else if(type == "E7")
-    cartridge = new CartridgeE7(image);
+    cartridge = specialize(new CartridgeE7(image));
   else if(type == "F4")
-    cartridge = new CartridgeF4(image);
+    cartridge = specialize(new CartridgeF4(image));
   else if(type == "F4SC")
-    cartridge = new CartridgeF4SC(image);
+    cartridge = specialize(new CartridgeF4SC(image));
   else if(type == "F6")
-    cartridge = new CartridgeF6(image);
+    cartridge = specialize(new CartridgeF6(image));
   else if(type == "F6SC")
-    cartridge = new CartridgeF6SC(image);
+    cartridge = specialize(new CartridgeF6SC(image));
   else if(type == "F8")
-    cartridge = new CartridgeF8(image, false);
+    cartridge = specialize(new CartridgeF8(image, false));
   else if(type == "F8 swapped")
-    cartridge = new CartridgeF8(image, true);
+    cartridge = specialize(new CartridgeF8(image, true));
   else if(type == "F8SC")
-    cartridge = new CartridgeF8SC(image);
+    cartridge = specialize(new CartridgeF8SC(image));
   else if(type == "FASC")
-    cartridge = new CartridgeFASC(image);
+    cartridge = specialize(new CartridgeFASC(image));
   else if(type == "FE")
-    cartridge = new CartridgeFE(image);
+    cartridge = specialize(new CartridgeFE(image));
   else if(type == "MC")
-    cartridge = new CartridgeMC(image, size);
+    cartridge = specialize(new CartridgeMC(image, size));
   else if(type == "MB")
-    cartridge = new CartridgeMB(image);
+    cartridge = specialize(new CartridgeMB(image));
   else if(type == "CV")
-    cartridge = new CartridgeCV(image, size);
+    cartridge = specialize(new CartridgeCV(image, size));
   else if(type == "UA")
-    cartridge = new CartridgeUA(image);
+    cartridge = specialize(new CartridgeUA(image));
   else if(type == "0840")
-    cartridge = new Cartridge0840(image);
+    cartridge = specialize(new Cartridge0840(image));
   else
     ale::Logger::Error << "ERROR: Invalid cartridge type " << type << " ..." << endl;
 
+  if(cartridge)
+    cartridge->myAboutString = buf.str();
+
   return cartridge;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge::Cartridge()
+  : myPeek(&peekVirtual),
+    myPoke(&pokeVirtual)
 {
   unlockBank();
 }
@@ -468,5 +508,3 @@ Cartridge& Cartridge::operator = (const Cartridge&)
   return *this;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Cartridge::myAboutString;
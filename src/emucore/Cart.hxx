@@ -62,10 +62,29 @@ class Cartridge : public Device
     */
     virtual ~Cartridge();
 
+    /**
+      Get the byte at the specified address through the peek() of the
+      cartridge's concrete class, which create() selected, rather than
+      through virtual dispatch.
+
+      @param address The address to read
+      @return The byte at the address
+    */
+    uInt8 peekCartridge(uInt16 address) { return myPeek(this, address); }
+
+    /**
+      Change the byte at the specified address through the poke() of the
+      cartridge's concrete class, as for peekCartridge().
+
+      @param address The address where the value should be stored
+      @param value The value to be stored at the address
+    */
+    void pokeCartridge(uInt16 address, uInt8 value) { myPoke(this, address, value); }
+
     /**
       Query some information about this cartridge.
     */
-    static const std::string& about() { return myAboutString; }
+    const std::string& about() const { return myAboutString; }
 
     /**
       Save the internal (patched) ROM image.
@@ -192,9 +211,22 @@ class Cartridge : public Device
     */
     static bool isProbablyFE(const uInt8* image, uInt32 size);
 
+    /**
+      Make peekCartridge() and pokeCartridge() call the peek() and poke()
+      of class T, which the cartridge belongs to
+
+      @param cartridge  The cartridge just created
+      @return  The cartridge
+    */
+    template<class T> static T* specialize(T* cartridge);
+
   private:
     // Contains info about this cartridge in string format
-    static std::string myAboutString;
+    std::string myAboutString;
+
+    // The peek() and poke() of the cartridge's class; virtual calls until create() sets them
+    uInt8 (*myPeek)(Cartridge* cartridge, uInt16 address);
+    void (*myPoke)(Cartridge* cartridge, uInt16 address, uInt8 value);
 
     // Copy constructor isn't supported by cartridges so make it private
     Cartridge(const Cartridge&);
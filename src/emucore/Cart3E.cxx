@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "Random.hxx"
 #include "System.hxx"
@@ -40,7 +41,7 @@ Cartridge3E::Cartridge3E(const uInt8* image, uInt32 size)
   }
 
   // Initialize RAM with random values
-  class Random& random = Random::getInstance();
+  class Random random;
   for(uInt32 i = 0; i < 32768; ++i)
   {
     myRam[i] = random.next();
@@ -205,6 +206,29 @@ bool Cartridge3E::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Cartridge3E::snapshotSize()
+{
+  return sizeof(myCurrentBank) + sizeof(myRam);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3E::saveSnapshot(uInt8* block)
+{
+  memcpy(block, &myCurrentBank, sizeof(myCurrentBank));
+  memcpy(block + sizeof(myCurrentBank), myRam, sizeof(myRam));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3E::loadSnapshot(const uInt8* block)
+{
+  memcpy(&myCurrentBank, block, sizeof(myCurrentBank));
+  memcpy(myRam, block + sizeof(myCurrentBank), sizeof(myRam));
+
+  // Now, go to the current bank
+  bank(myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3E::bank(uInt16 bank)
 { 
@@ -115,6 +115,14 @@ class Cartridge3E : public Cartridge
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Snapshot the current bank and the RAM.
+      See Device::saveSnapshot().
+    */
+    virtual uInt32 snapshotSize();
+    virtual void saveSnapshot(uInt8* block);
+    virtual void loadSnapshot(const uInt8* block);
+
     /**
       Install pages for the specified bank in the system.
 
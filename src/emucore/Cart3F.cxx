@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "System.hxx"
 #include "TIA.hxx"
@@ -176,6 +177,28 @@ bool Cartridge3F::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Cartridge3F::snapshotSize()
+{
+  return sizeof(myCurrentBank);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3F::saveSnapshot(uInt8* block)
+{
+  memcpy(block, &myCurrentBank, sizeof(myCurrentBank));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3F::loadSnapshot(const uInt8* block)
+{
+  memcpy(&myCurrentBank, block, sizeof(myCurrentBank));
+
+  // Remember what bank we were in
+  // Now, go to the current bank
+  bank(myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3F::bank(uInt16 bank)
 { 
@@ -85,6 +85,14 @@ class Cartridge4A50 : public Cartridge
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      This cartridge has no state to snapshot.
+      See Device::saveSnapshot().
+    */
+    virtual uInt32 snapshotSize();
+    virtual void saveSnapshot(uInt8* block);
+    virtual void loadSnapshot(const uInt8* block);
+
     /**
       Install pages for the specified bank in the system.
 
@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "Random.hxx"
 #include "System.hxx"
@@ -38,7 +39,7 @@ CartridgeCV::CartridgeCV(const uInt8* image, uInt32 size)
     }
 
     // Initialize RAM with random values
-  class Random& random = Random::getInstance();
+  class Random random;
 
     for(uInt32 i = 0; i < 1024; ++i)
     {
@@ -190,6 +191,24 @@ bool CartridgeCV::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeCV::snapshotSize()
+{
+  return sizeof(myRAM);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCV::saveSnapshot(uInt8* block)
+{
+  memcpy(block, myRAM, sizeof(myRAM));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCV::loadSnapshot(const uInt8* block)
+{
+  memcpy(myRAM, block, sizeof(myRAM));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCV::bank(uInt16 bank)
 {
@@ -88,6 +88,14 @@ class CartridgeCV : public Cartridge
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Snapshot the RAM.
+      See Device::saveSnapshot().
+    */
+    virtual uInt32 snapshotSize();
+    virtual void saveSnapshot(uInt8* block);
+    virtual void loadSnapshot(const uInt8* block);
+
     /**
       Install pages for the specified bank in the system.
 
@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "System.hxx"
 #include "Serializer.hxx"
@@ -252,6 +253,24 @@ bool CartridgeE0::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeE0::snapshotSize()
+{
+  return sizeof(myCurrentSlice);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE0::saveSnapshot(uInt8* block)
+{
+  memcpy(block, myCurrentSlice, sizeof(myCurrentSlice));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE0::loadSnapshot(const uInt8* block)
+{
+  memcpy(myCurrentSlice, block, sizeof(myCurrentSlice));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE0::bank(uInt16 bank)
 {
@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "Random.hxx"
 #include "System.hxx"
@@ -35,7 +36,7 @@ CartridgeE7::CartridgeE7(const uInt8* image)
   }
 
   // Initialize RAM with random values
-  class Random& random = Random::getInstance();
+  class Random random;
 
   for(uInt32 i = 0; i < 2048; ++i)
   {
@@ -247,6 +248,36 @@ bool CartridgeE7::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeE7::snapshotSize()
+{
+  return sizeof(myCurrentSlice) + sizeof(myCurrentRAM) + sizeof(myRAM);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE7::saveSnapshot(uInt8* block)
+{
+  memcpy(block, myCurrentSlice, sizeof(myCurrentSlice));
+  block += sizeof(myCurrentSlice);
+  memcpy(block, &myCurrentRAM, sizeof(myCurrentRAM));
+  block += sizeof(myCurrentRAM);
+  memcpy(block, myRAM, sizeof(myRAM));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE7::loadSnapshot(const uInt8* block)
+{
+  memcpy(myCurrentSlice, block, sizeof(myCurrentSlice));
+  block += sizeof(myCurrentSlice);
+  memcpy(&myCurrentRAM, block, sizeof(myCurrentRAM));
+  block += sizeof(myCurrentRAM);
+  memcpy(myRAM, block, sizeof(myRAM));
+
+  // Set up the previously used banks for the RAM and segment
+  bankRAM(myCurrentRAM);
+  bank(myCurrentSlice[0]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE7::bank(uInt16 slice)
 { 
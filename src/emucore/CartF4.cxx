@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "System.hxx"
 #include "Serializer.hxx"
@@ -157,6 +158,27 @@ bool CartridgeF4::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeF4::snapshotSize()
+{
+  return sizeof(myCurrentBank);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4::saveSnapshot(uInt8* block)
+{
+  memcpy(block, &myCurrentBank, sizeof(myCurrentBank));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4::loadSnapshot(const uInt8* block)
+{
+  memcpy(&myCurrentBank, block, sizeof(myCurrentBank));
+
+  // Remember what bank we were in
+  bank(myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4::bank(uInt16 bank)
 { 
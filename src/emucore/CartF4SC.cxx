@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "Random.hxx"
 #include "System.hxx"
@@ -35,7 +36,7 @@ CartridgeF4SC::CartridgeF4SC(const uInt8* image)
   }
 
   // Initialize RAM with random values
-  class Random& random = Random::getInstance();
+  class Random random;
 
   for(uInt32 i = 0; i < 128; ++i)
   {
@@ -197,6 +198,29 @@ bool CartridgeF4SC::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeF4SC::snapshotSize()
+{
+  return sizeof(myCurrentBank) + sizeof(myRAM);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4SC::saveSnapshot(uInt8* block)
+{
+  memcpy(block, &myCurrentBank, sizeof(myCurrentBank));
+  memcpy(block + sizeof(myCurrentBank), myRAM, sizeof(myRAM));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4SC::loadSnapshot(const uInt8* block)
+{
+  memcpy(&myCurrentBank, block, sizeof(myCurrentBank));
+  memcpy(myRAM, block + sizeof(myCurrentBank), sizeof(myRAM));
+
+  // Remember what bank we were in
+  bank(myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4SC::bank(uInt16 bank)
 { 
@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "System.hxx"
 #include "Serializer.hxx"
@@ -198,6 +199,27 @@ bool CartridgeF6::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeF6::snapshotSize()
+{
+  return sizeof(myCurrentBank);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6::saveSnapshot(uInt8* block)
+{
+  memcpy(block, &myCurrentBank, sizeof(myCurrentBank));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6::loadSnapshot(const uInt8* block)
+{
+  memcpy(&myCurrentBank, block, sizeof(myCurrentBank));
+
+  // Remember what bank we were in
+  bank(myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6::bank(uInt16 bank)
 { 
@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "Random.hxx"
 #include "System.hxx"
@@ -35,7 +36,7 @@ CartridgeF6SC::CartridgeF6SC(const uInt8* image)
   }
 
   // Initialize RAM with random values
-  class Random& random = Random::getInstance();
+  class Random random;
 
   for(uInt32 i = 0; i < 128; ++i)
   {
@@ -243,6 +244,29 @@ bool CartridgeF6SC::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeF6SC::snapshotSize()
+{
+  return sizeof(myCurrentBank) + sizeof(myRAM);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6SC::saveSnapshot(uInt8* block)
+{
+  memcpy(block, &myCurrentBank, sizeof(myCurrentBank));
+  memcpy(block + sizeof(myCurrentBank), myRAM, sizeof(myRAM));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6SC::loadSnapshot(const uInt8* block)
+{
+  memcpy(&myCurrentBank, block, sizeof(myCurrentBank));
+  memcpy(myRAM, block + sizeof(myCurrentBank), sizeof(myRAM));
+
+  // Remember what bank we were in
+  bank(myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6SC::bank(uInt16 bank)
 { 
@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 
 #include "Random.hxx"
 #include "System.hxx"
@@ -38,7 +39,7 @@ CartridgeMC::CartridgeMC(const uInt8* image, uInt32 size)
   myRAM = new uInt8[32 * 1024];
 
   // Initialize RAM with random values
-  class Random& random = Random::getInstance();
+  class Random random;
 
   for(i = 0; i < 32 * 1024; ++i)
   {
@@ -292,6 +293,26 @@ bool CartridgeMC::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeMC::snapshotSize()
+{
+  return sizeof(myCurrentBlock) + 32 * 1024;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeMC::saveSnapshot(uInt8* block)
+{
+  memcpy(block, myCurrentBlock, sizeof(myCurrentBlock));
+  memcpy(block + sizeof(myCurrentBlock), myRAM, 32 * 1024);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeMC::loadSnapshot(const uInt8* block)
+{
+  memcpy(myCurrentBlock, block, sizeof(myCurrentBlock));
+  memcpy(myRAM, block + sizeof(myCurrentBlock), 32 * 1024);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeMC::bank(uInt16 b)
 {
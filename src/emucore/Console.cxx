@@ -158,6 +158,9 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   if(myOSystem->settings().getString("cpu") == "low") {
     m6502 = new M6502Low(1);
   }
+  else if(myOSystem->settings().getString("cpu") == "threaded") {
+    m6502 = new M6502HighThreaded(1);
+  }
   else {
     m6502 = new M6502High(1);
   }
@@ -17,37 +17,41 @@
 //============================================================================
 
 #include "Deserializer.hxx"
-#include <sstream>
 using namespace std;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Deserializer::Deserializer(const string stream_str):
-myStream(stream_str) {
-    
-}
+Deserializer::Deserializer(const string& stream_str):
+myData(stream_str.data()),
+mySize(stream_str.size()),
+myPosition(0) {
 
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Deserializer::Deserializer(const char* data, uInt32 size):
+myData(data),
+mySize(size),
+myPosition(0) {
 
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Deserializer::close(void)
 {
-  myStream.clear();
+  myPosition = mySize;
 }
 
-
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Deserializer::getInt(void)
 {
-  if(myStream.eof())
+  if(myPosition + 4 > mySize)
     throw "Deserializer: end of file";
 
   int val = 0;
-  unsigned char buf[4];
-  myStream.read((char*)buf, 4);
+  const unsigned char* buf = (const unsigned char*)myData + myPosition;
   for(int i = 0; i < 4; ++i)
     val += (int)(buf[i]) << (i<<3);
+  myPosition += 4;
 
   return val;
 }
@@ -56,14 +60,9 @@ int Deserializer::getInt(void)
 string Deserializer::getString(void)
 {
   int len = getInt();
-  string str;
-  str.resize((string::size_type)len);
-  myStream.read(&str[0], (streamsize)len);
-
-  if(myStream.bad())
-    throw "Deserializer: file read failed";
+  const char* str = (const char*)getBlock((uInt32)len);
 
-  return str;
+  return string(str, len);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -81,3 +80,15 @@ bool Deserializer::getBool(void)
 
   return result;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* Deserializer::getBlock(uInt32 size)
+{
+  if(size > mySize - myPosition)
+    throw "Deserializer: file read failed";
+
+  const uInt8* block = (const uInt8*)myData + myPosition;
+  myPosition += size;
+
+  return block;
+}
@@ -19,60 +19,76 @@
 #ifndef DESERIALIZER_HXX
 #define DESERIALIZER_HXX
 
-#include <sstream>
+#include <string>
 #include "m6502/src/bspf/src/bspf.hxx"
 
 /**
  This class implements a Deserializer device, whereby data is
  deserialized from an input binary file in a system-independent
  way.
- 
+
  All ints should be cast to their appropriate data type upon method
  return.
- 
+
  @author  Stephen Anthony
  @version $Id: Deserializer.hxx,v 1.11 2007/01/01 18:04:47 stephena Exp $
- 
+
  Revised for ALE on Sep 20, 2009
- The new version uses a stringstream (not a file stream)
- 
- TODO: don't copy the whole streams. 
+ The new version reads from an in-memory byte buffer (not a file stream).
+ The buffer is not copied, so it must outlive the Deserializer.
  */
 class Deserializer {
     public:
         /**
-         Creates a new Deserializer device.
+         Creates a new Deserializer device reading from the given data.
          */
-        Deserializer(const std::string stream_str);
-        
+        Deserializer(const std::string& stream_str);
+        Deserializer(const char* data, uInt32 size);
+
         void close(void);
 
         /**
          Reads an int value from the current input stream.
-         
+
          @result The int value which has been read from the stream.
          */
         int getInt(void);
-        
+
         /**
          Reads a string from the current input stream.
-         
+
          @result The string which has been read from the stream.
          */
         std::string getString(void);
-        
+
         /**
          Reads a boolean value from the current input stream.
-         
+
          @result The boolean value which has been read from the stream.
          */
         bool getBool(void);
-        
+
+        /**
+         Reads a raw block written by Serializer::putBlock, without copying it.
+
+         @param size The size of the block in bytes.
+         @result A pointer to the start of the block.
+         */
+        const uInt8* getBlock(uInt32 size);
+
         bool isOpen(void) {return true;}
+
+        /**
+         Answers whether every byte of the input has been read.
+         */
+        bool atEnd(void) const {return myPosition == mySize;}
+
     private:
-        // The stream to get the deserialized data from.
-        std::stringstream myStream;
-        
+        // The data to get the deserialized values from, and the read position.
+        const char* myData;
+        uInt32 mySize;
+        uInt32 myPosition;
+
         enum {
             TruePattern  = 0xfab1fab2,
             FalsePattern = 0xbad1bad2
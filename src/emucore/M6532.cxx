@@ -17,6 +17,7 @@
 //============================================================================
 
 #include <assert.h>
+#include <cstring>
 #include "Console.hxx"
 #include "M6532.hxx"
 #include "Switches.hxx"
@@ -217,6 +218,21 @@ uInt8 M6532::peek(uInt16 addr)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 M6532::lastNonZeroTimerRead() const
+{
+  // A read sees (cycles - 1 - myCyclesWhenTimerSet) cycles since the timer
+  // was set, see peek(), and gives zero once myTimer - 1 intervals passed
+  return myCyclesWhenTimerSet + ((Int32)myTimer - 1) * (1 << myIntervalShift);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 M6532::timerValueAt(Int32 cycles) const
+{
+  uInt32 delta = (cycles - 1) - myCyclesWhenTimerSet;
+  return (uInt8)((Int32)myTimer - (Int32)(delta >> myIntervalShift) - 1);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6532::poke(uInt16 addr, uInt8 value)
 {
@@ -393,6 +409,46 @@ bool M6532::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6532::snapshotSize()
+{
+  return sizeof(myRAM) + sizeof(Snapshot);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::saveSnapshot(uInt8* block)
+{
+  memcpy(block, myRAM, sizeof(myRAM));
+
+  Snapshot s;
+  memset(&s, 0, sizeof(s));
+  s.timer = myTimer;
+  s.intervalShift = myIntervalShift;
+  s.cyclesWhenTimerSet = myCyclesWhenTimerSet;
+  s.cyclesWhenInterruptReset = myCyclesWhenInterruptReset;
+  s.timerReadAfterInterrupt = myTimerReadAfterInterrupt;
+  s.DDRA = myDDRA;
+  s.DDRB = myDDRB;
+
+  memcpy(block + sizeof(myRAM), &s, sizeof(s));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::loadSnapshot(const uInt8* block)
+{
+  memcpy(myRAM, block, sizeof(myRAM));
+
+  Snapshot s;
+  memcpy(&s, block + sizeof(myRAM), sizeof(s));
+
+  myTimer = s.timer;
+  myIntervalShift = s.intervalShift;
+  myCyclesWhenTimerSet = s.cyclesWhenTimerSet;
+  myCyclesWhenInterruptReset = s.cyclesWhenInterruptReset;
+  myTimerReadAfterInterrupt = s.timerReadAfterInterrupt;
+  myDDRA = s.DDRA;
+  myDDRB = s.DDRB;
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6532::M6532(const M6532& c)
@@ -93,6 +93,14 @@ class M6532 : public Device
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Snapshot the RAM, timer and data direction registers.
+      See Device::saveSnapshot().
+    */
+    virtual uInt32 snapshotSize();
+    virtual void saveSnapshot(uInt8* block);
+    virtual void loadSnapshot(const uInt8* block);
+
    public:
     /**
       Get the byte at the specified address
@@ -109,6 +117,24 @@ class M6532 : public Device
     */
     virtual void poke(uInt16 address, uInt8 value);
 
+    /**
+      Answer the last value of the system cycle counter at which reading
+      the timer (INTIM) has no side effects and gives a non-zero value.
+      This doesn't change until the timer is written again.
+
+      @return The last system cycle count of a non-zero timer read
+    */
+    Int32 lastNonZeroTimerRead() const;
+
+    /**
+      Answer the value that reading the timer gives at the specified
+      system cycle count, which must not be after lastNonZeroTimerRead().
+
+      @param cycles The system cycle count of the read
+      @return The value of the timer
+    */
+    uInt8 timerValueAt(Int32 cycles) const;
+
   private:
     // Reference to the console
     const Console& myConsole;
@@ -137,6 +163,18 @@ class M6532 : public Device
     // Data Direction Register for Port B
     uInt8 myDDRB;
 
+    // Layout of the registers which follow the RAM in a snapshot block
+    struct Snapshot
+    {
+      uInt32 timer;
+      uInt32 intervalShift;
+      Int32 cyclesWhenTimerSet;
+      Int32 cyclesWhenInterruptReset;
+      bool timerReadAfterInterrupt;
+      uInt8 DDRA;
+      uInt8 DDRB;
+    };
+
   private:
     // Copy constructor isn't supported by this class so make it private
     M6532(const M6532&);
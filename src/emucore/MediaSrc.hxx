@@ -119,6 +119,14 @@ class MediaSource
     */
     virtual void setSound(Sound& sound) = 0;
 
+    /**
+      Enables or disables drawing into the frame buffer. Everything else,
+      including collisions, is emulated identically either way.
+
+      @param render  Whether to draw the frames generated from now on
+    */
+    virtual void setRendering(bool render) = 0;
+
   private:
     // Copy constructor isn't supported by this class so make it private
     MediaSource(const MediaSource&);
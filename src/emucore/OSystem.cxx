@@ -336,14 +336,17 @@ void OSystem::createSound()
   if (mySettings->getBool("sound") == true) {
       mySound = new SoundSDL(this);
       mySound->initialize();
-  }
-  else {
-      mySound = new SoundNull(this);
+      return;
   }
 #else
   mySettings->setBool("sound", false);
-  mySound = new SoundNull(this);
 #endif
+
+  // Without display audio, sound is only generated when it is recorded
+  if (!mySettings->getString("record_sound_filename").empty())
+      mySound = new SoundRecorder(this);
+  else
+      mySound = new SoundNull(this);
 }
 
 
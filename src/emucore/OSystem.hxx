@@ -32,6 +32,7 @@ class VideoDialog;
 //ALE  #include "FrameBuffer.hxx"
 #include "Sound.hxx"
 #include "../common/SoundNull.hxx"
+#include "../common/SoundRecorder.hxx"
 #include "Settings.hxx"
 #include "Console.hxx"
 #include "Event.hxx"  //ALE 
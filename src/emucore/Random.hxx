@@ -27,6 +27,9 @@ class Deserializer;
 /**
   This Random class uses a Mersenne Twister to provide pseudorandom numbers.
   The class itself is derived from the original 'Random' class by Bradford W. Mott.
+  There is no shared instance: every generator belongs to a single object (the
+  OSystem, or a cartridge initializing its RAM), so that separate emulators
+  never draw from the same stream.
 */
 class Random
 {
@@ -61,10 +64,6 @@ class Random
     */
     double nextDouble();
 
-    // Returns a static Random object. DO NOT USE THIS. This is mostly meant for use by the
-    // code for the various cartridges. 
-    static Random& getInstance();
-
     /**
       Serializes the RNG state.
     */
@@ -80,9 +79,6 @@ class Random
     // Actual rng (implementation hidden away from the header to avoid depending on rng libraries). 
     class Impl;
     Impl *m_pimpl;
-
-    // A static Random object. Don't use this.
-    static Random s_random;
 };
 #endif
 
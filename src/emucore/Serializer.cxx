@@ -21,35 +21,30 @@ using namespace std;
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Serializer::Serializer(void) {
-    myStream.clear();
-    
+Serializer::Serializer(uInt32 reserve)
+{
+    myBuffer.reserve(reserve);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::~Serializer(void)
 {
-    close();
 }
 
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::close(void)
 {
-    myStream.clear();
+    myBuffer.clear();
 }
 
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putInt(int value)
 {
-    unsigned char buf[4];
+    char buf[4];
     for(int i = 0; i < 4; ++i)
         buf[i] = (value >> (i<<3)) & 0xff;
-    
-    myStream.write((char*)buf, 4);
-    if(myStream.bad())
-        throw "Serializer: file write failed";
+
+    myBuffer.append(buf, 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -57,10 +52,7 @@ void Serializer::putString(const string& str)
 {
     int len = str.length();
     putInt(len);
-    myStream.write(str.data(), (streamsize)len);
-    
-    if(myStream.bad())
-        throw "Serializer: file write failed";
+    myBuffer.append(str.data(), len);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -69,3 +61,11 @@ void Serializer::putBool(bool b)
     putInt(b ? TruePattern: FalsePattern);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* Serializer::putBlock(uInt32 size)
+{
+    string::size_type start = myBuffer.size();
+    myBuffer.resize(start + size);
+
+    return (uInt8*)&myBuffer[start];
+}
@@ -19,7 +19,7 @@
 #ifndef SERIALIZER_HXX
 #define SERIALIZER_HXX
 
-#include <sstream>
+#include <string>
 #include "m6502/src/bspf/src/bspf.hxx"
 
 /**
@@ -33,9 +33,9 @@
 
   @author  Stephen Anthony
   @version $Id: Serializer.hxx,v 1.12 2007/01/01 18:04:49 stephena Exp $
-  
+
   Revised for ALE on Sep 20, 2009
-  The new version uses a stringstream (not a file stream)
+  The new version writes into an in-memory byte buffer (not a file stream)
 */
 class Serializer
 {
@@ -43,20 +43,21 @@ class Serializer
     /**
       Creates a new Serializer device.
 
+      @param reserve The number of bytes to preallocate for the output
     */
-    Serializer(void);
+    Serializer(uInt32 reserve = 0);
 
     /**
       Destructor
     */
     virtual ~Serializer(void);
 
-
+  public:
     /**
       Closes the current output stream.
     */
     void close(void);
-    
+
     bool isOpen(void) {return true;}
 
     /**
@@ -80,14 +81,34 @@ class Serializer
     */
     void putBool(bool b);
 
-    // Accessor for myStream
-    // TODO: don't copy the whole streams. 
-    std::string get_str(void) const {
-        return myStream.str();
+    /**
+      Appends a raw block of the given size to the output stream and
+      returns a pointer to it, so that the caller can fill it in place.
+      The pointer is only valid until the next write.
+
+      @param size The size of the block in bytes.
+      @return A pointer to the start of the block.
+    */
+    uInt8* putBlock(uInt32 size);
+
+    // Accessor for the serialized data
+    const std::string& get_str(void) const {
+        return myBuffer;
     }
+
+    /**
+      Exchanges the serialized data with the given string.  Swapping a
+      buffer in, closing and writing reuses its storage.
+
+      @param buffer The string to exchange the data with.
+    */
+    void swap(std::string& buffer) {
+        myBuffer.swap(buffer);
+    }
+
   private:
-    // The stream to send the serialized data to.
-    std::stringstream myStream;
+    // The buffer to send the serialized data to.
+    std::string myBuffer;
 
     enum {
       TruePattern  = 0xfab1fab2,
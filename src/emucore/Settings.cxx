@@ -285,6 +285,9 @@ void Settings::usage() {
 #endif
        "   -random_seed [n|time] (default: time)\n"
        "     Sets the seed used for random number generation\n"
+       "   -cpu [low|high|threaded] (default: low)\n"
+       "     6502 emulator: 'high' emulates every memory access cycle-exactly, and\n"
+       "     'threaded' is a faster implementation of 'high'\n"
 #ifdef __USE_SDL
        "   -display_screen [true|false] (default: false)\n"
        "     Displays the game screen\n"
@@ -301,6 +304,21 @@ void Settings::usage() {
        "     Ends each episode after this number of frames. 0 means never.\n"
        "   -color_averaging [true|false] (default: false)\n"
        "     Phosphor blends screens to reduce flicker\n"
+       "   -fast_tia_update [true|false] (default: false)\n"
+       "     Does not draw the screen, for agents which only read the RAM. Emulation\n"
+       "     is otherwise unchanged.\n"
+       "   -render_final_frames [true|false] (default: false)\n"
+       "     With frame skipping, only draws the last two frames of each action\n"
+       "   -vector_tia_update [true|false] (default: true)\n"
+       "     Draws with SSSE3 where the CPU supports it, with the same screen.\n"
+       "   -lazy_tia_collisions [true|false] (default: true)\n"
+       "     Computes collisions only when the game reads them, with the same results.\n"
+       "   -preprocess_max_pool [true|false] (default: false)\n"
+       "     Preprocessed screens take the maximum of the last two frames\n"
+       "   -preprocess_height n, -preprocess_width n (default: 0)\n"
+       "     Size preprocessed screens are resized to. 0 keeps the screen size.\n"
+       "   -frame_stack n (default: 0)\n"
+       "     Number of preprocessed screens kept in the frame stack. 0 disables it.\n"
        "   -record_screen_dir [save_directory]\n"
        "     Saves game screen images to save_directory\n"
        "   -repeat_action_probability (default: 0.25)\n"
@@ -705,6 +723,14 @@ void Settings::setDefaultSettings() {
     boolSettings.insert(pair<string, bool>("restricted_action_set", false));
     intSettings.insert(pair<string, int>("random_seed", 0));
     boolSettings.insert(pair<string, bool>("color_averaging", false));
+    boolSettings.insert(pair<string, bool>("fast_tia_update", false));
+    boolSettings.insert(pair<string, bool>("render_final_frames", false));
+    boolSettings.insert(pair<string, bool>("vector_tia_update", true));
+    boolSettings.insert(pair<string, bool>("lazy_tia_collisions", true));
+    boolSettings.insert(pair<string, bool>("preprocess_max_pool", false));
+    intSettings.insert(pair<string, int>("preprocess_height", 0));
+    intSettings.insert(pair<string, int>("preprocess_width", 0));
+    intSettings.insert(pair<string, int>("frame_stack", 0));
     boolSettings.insert(pair<string, bool>("send_rgb", false));
     intSettings.insert(pair<string, int>("frame_skip", 1));
     floatSettings.insert(pair<string, float>("repeat_action_probability", 0.25));
@@ -20,10 +20,12 @@
 #define SOUND_HXX
 
 class OSystem;
-class Serializer;
-class Deserializer;
+
+#include <cstring>
 
 #include "m6502/src/bspf/src/bspf.hxx"
+#include "Serializer.hxx"
+#include "Deserializer.hxx"
 
 /**
   This class is an abstract base class for the various sound objects.
@@ -139,6 +141,15 @@ class Sound
       */
     virtual void recordNextFrame() = 0;
 
+    /**
+      Answers true iff the samples of this sound device are played or
+      recorded.  When they aren't, the audio register writes don't need
+      to be passed on to the device.
+
+      @return true iff the sound device consumes the audio registers
+    */
+    virtual bool isConsumed() const { return true; }
+
 public:
     /**
       Loads the current state of this device from the given Deserializer.
@@ -156,6 +167,42 @@ public:
     */
     virtual bool save(Serializer& out) = 0;
 
+    /**
+      Get the size of the block written by saveSnapshot().  By default
+      this is the size of the serialized state.
+    */
+    virtual uInt32 snapshotSize()
+    {
+      Serializer out;
+      save(out);
+      return out.get_str().size();
+    }
+
+    /**
+      Copies the current state of this device into a block of
+      snapshotSize() bytes.  By default the serialized state is stored.
+
+      @param block The block to save to
+    */
+    virtual void saveSnapshot(uInt8* block)
+    {
+      Serializer out;
+      save(out);
+      memcpy(block, out.get_str().data(), out.get_str().size());
+    }
+
+    /**
+      Restores the state of this device from a block written by
+      saveSnapshot().
+
+      @param block The block to load from
+    */
+    virtual void loadSnapshot(const uInt8* block)
+    {
+      Deserializer in((const char*)block, 0xFFFFFFFF);
+      load(in);
+    }
+
   protected:
     // The OSystem for this sound object
     OSystem* myOSystem;
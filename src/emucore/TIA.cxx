@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 
 #include "Console.hxx"
 #include "Control.hxx"
@@ -32,6 +33,21 @@
 #include "Sound.hxx"
 using namespace std;
 
+// The vectorized scanline renderer is compiled for SSSE3 whatever the build
+// flags, and only used after checking at runtime that the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TIA_X86_KERNELS
+#include <immintrin.h>
+
+static bool supportsVectorScanline()
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
+}
+
+static const bool ourVectorScanline = supportsVectorScanline();
+#endif
+
 #define HBLANK 68
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -39,6 +55,7 @@ TIA::TIA(const Console& console, Settings& settings)
     : myConsole(console),
       mySettings(settings),
       mySound(NULL),
+      mySoundConsumed(false),
       myColorLossEnabled(false),
       myMaximumNumberOfScanlines(262),
       myCOLUBK(myColor[0]),
@@ -95,24 +112,28 @@ TIA::TIA(const Console& console, Settings& settings)
     }
   }
 
-  for(i = 0; i < 640; ++i)
-    ourDisabledMaskTable[i] = 0;
-
-  // Compute all of the mask tables
-  computeBallMaskTable();
-  computeCollisionTable();
-  computeMissleMaskTable();
-  computePlayerMaskTable();
-  computePlayerPositionResetWhenTable();
-  computePlayerReflectTable();
-  computePlayfieldMaskTable();
+  // The mask tables are shared by every TIA, so they are computed only once;
+  // this allows consoles to be created concurrently from several threads
+  static std::once_flag maskTablesComputed;
+  std::call_once(maskTablesComputed, computeMaskTables);
 
   // Init stats counters
   myFrameCounter = 0;
 
+  // No collisions are waiting to be computed
+  myCollisionSegmentCount = 0;
+
   myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
 
   fastUpdate = settings.getBool("fast_tia_update", false);
+
+  // Both are only turned off to check that they leave emulation unchanged
+#ifdef TIA_X86_KERNELS
+  myVectorScanline = ourVectorScanline && settings.getBool("vector_tia_update", false);
+#else
+  myVectorScanline = false;
+#endif
+  myLazyCollisions = settings.getBool("lazy_tia_collisions", false);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -170,6 +191,7 @@ void TIA::reset()
   myRESMP0 = false;
   myRESMP1 = false;
   myCollision = 0;
+  myCollisionSegmentCount = 0;
   myPOSP0 = 0;
   myPOSP1 = 0;
   myPOSM0 = 0;
@@ -357,6 +379,7 @@ bool TIA::save(Serializer& out)
     out.putBool(myVDELBL);
     out.putBool(myRESMP0);
     out.putBool(myRESMP1);
+    updateCollisions(0x7FFF);
     out.putInt(myCollision);
     out.putInt(myPOSP0);
     out.putInt(myPOSP1);
@@ -455,6 +478,7 @@ bool TIA::load(Deserializer& in)
     myRESMP0 = in.getBool();
     myRESMP1 = in.getBool();
     myCollision = (uInt16) in.getInt();
+    myCollisionSegmentCount = 0;
     myPOSP0 = (Int16) in.getInt();
     myPOSP1 = (Int16) in.getInt();
     myPOSM0 = (Int16) in.getInt();
@@ -500,6 +524,163 @@ bool TIA::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::snapshotSize()
+{
+  return sizeof(Snapshot) + mySound->snapshotSize();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::saveSnapshot(uInt8* block)
+{
+  Snapshot s;
+  memset(&s, 0, sizeof(s));
+
+  s.clockWhenFrameStarted = myClockWhenFrameStarted;
+  s.clockStartDisplay = myClockStartDisplay;
+  s.clockStopDisplay = myClockStopDisplay;
+  s.clockAtLastUpdate = myClockAtLastUpdate;
+  s.clocksToEndOfScanLine = myClocksToEndOfScanLine;
+  s.scanlineCountForLastFrame = myScanlineCountForLastFrame;
+  s.currentScanline = myCurrentScanline;
+  s.VSYNCFinishClock = myVSYNCFinishClock;
+
+  s.enabledObjects = myEnabledObjects;
+
+  s.VSYNC = myVSYNC;
+  s.VBLANK = myVBLANK;
+  s.NUSIZ0 = myNUSIZ0;
+  s.NUSIZ1 = myNUSIZ1;
+
+  s.COLUP0 = myCOLUP0;
+  s.COLUP1 = myCOLUP1;
+  s.COLUPF = myCOLUPF;
+  s.COLUBK = myCOLUBK;
+
+  s.CTRLPF = myCTRLPF;
+  s.playfieldPriorityAndScore = myPlayfieldPriorityAndScore;
+  s.REFP0 = myREFP0;
+  s.REFP1 = myREFP1;
+  s.PF = myPF;
+  s.GRP0 = myGRP0;
+  s.GRP1 = myGRP1;
+  s.DGRP0 = myDGRP0;
+  s.DGRP1 = myDGRP1;
+  s.ENAM0 = myENAM0;
+  s.ENAM1 = myENAM1;
+  s.ENABL = myENABL;
+  s.DENABL = myDENABL;
+  s.HMP0 = myHMP0;
+  s.HMP1 = myHMP1;
+  s.HMM0 = myHMM0;
+  s.HMM1 = myHMM1;
+  s.HMBL = myHMBL;
+  s.VDELP0 = myVDELP0;
+  s.VDELP1 = myVDELP1;
+  s.VDELBL = myVDELBL;
+  s.RESMP0 = myRESMP0;
+  s.RESMP1 = myRESMP1;
+  updateCollisions(0x7FFF);
+  s.collision = myCollision;
+  s.POSP0 = myPOSP0;
+  s.POSP1 = myPOSP1;
+  s.POSM0 = myPOSM0;
+  s.POSM1 = myPOSM1;
+  s.POSBL = myPOSBL;
+
+  s.currentGRP0 = myCurrentGRP0;
+  s.currentGRP1 = myCurrentGRP1;
+
+  s.lastHMOVEClock = myLastHMOVEClock;
+  s.HMOVEBlankEnabled = myHMOVEBlankEnabled;
+  s.M0CosmicArkMotionEnabled = myM0CosmicArkMotionEnabled;
+  s.M0CosmicArkCounter = myM0CosmicArkCounter;
+
+  s.dumpEnabled = myDumpEnabled;
+  s.dumpDisabledCycle = myDumpDisabledCycle;
+
+  memcpy(block, &s, sizeof(s));
+
+  // Save the sound sample stuff ...
+  mySound->saveSnapshot(block + sizeof(s));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::loadSnapshot(const uInt8* block)
+{
+  Snapshot s;
+  memcpy(&s, block, sizeof(s));
+
+  myClockWhenFrameStarted = s.clockWhenFrameStarted;
+  myClockStartDisplay = s.clockStartDisplay;
+  myClockStopDisplay = s.clockStopDisplay;
+  myClockAtLastUpdate = s.clockAtLastUpdate;
+  myClocksToEndOfScanLine = s.clocksToEndOfScanLine;
+  myScanlineCountForLastFrame = s.scanlineCountForLastFrame;
+  myCurrentScanline = s.currentScanline;
+  myVSYNCFinishClock = s.VSYNCFinishClock;
+
+  myEnabledObjects = s.enabledObjects;
+
+  myVSYNC = s.VSYNC;
+  myVBLANK = s.VBLANK;
+  myNUSIZ0 = s.NUSIZ0;
+  myNUSIZ1 = s.NUSIZ1;
+
+  myCOLUP0 = s.COLUP0;
+  myCOLUP1 = s.COLUP1;
+  myCOLUPF = s.COLUPF;
+  myCOLUBK = s.COLUBK;
+
+  myCTRLPF = s.CTRLPF;
+  myPlayfieldPriorityAndScore = s.playfieldPriorityAndScore;
+  myREFP0 = s.REFP0;
+  myREFP1 = s.REFP1;
+  myPF = s.PF;
+  myGRP0 = s.GRP0;
+  myGRP1 = s.GRP1;
+  myDGRP0 = s.DGRP0;
+  myDGRP1 = s.DGRP1;
+  myENAM0 = s.ENAM0;
+  myENAM1 = s.ENAM1;
+  myENABL = s.ENABL;
+  myDENABL = s.DENABL;
+  myHMP0 = s.HMP0;
+  myHMP1 = s.HMP1;
+  myHMM0 = s.HMM0;
+  myHMM1 = s.HMM1;
+  myHMBL = s.HMBL;
+  myVDELP0 = s.VDELP0;
+  myVDELP1 = s.VDELP1;
+  myVDELBL = s.VDELBL;
+  myRESMP0 = s.RESMP0;
+  myRESMP1 = s.RESMP1;
+  myCollision = s.collision;
+  myCollisionSegmentCount = 0;
+  myPOSP0 = s.POSP0;
+  myPOSP1 = s.POSP1;
+  myPOSM0 = s.POSM0;
+  myPOSM1 = s.POSM1;
+  myPOSBL = s.POSBL;
+
+  myCurrentGRP0 = s.currentGRP0;
+  myCurrentGRP1 = s.currentGRP1;
+
+  myLastHMOVEClock = s.lastHMOVEClock;
+  myHMOVEBlankEnabled = s.HMOVEBlankEnabled;
+  myM0CosmicArkMotionEnabled = s.M0CosmicArkMotionEnabled;
+  myM0CosmicArkCounter = s.M0CosmicArkCounter;
+
+  myDumpEnabled = s.dumpEnabled;
+  myDumpDisabledCycle = s.dumpDisabledCycle;
+
+  // Load the sound sample stuff ...
+  mySound->loadSnapshot(block + sizeof(s));
+
+  // Reset TIA bits to be on
+  enableBits(true);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::update()
 {
@@ -522,7 +703,7 @@ void TIA::update()
 
   if(myPartialFrameFlag) {
     // grey out old frame contents
-    if(!myFrameGreyed) greyOutFrame();
+    if(!myFrameGreyed && !fastUpdate) greyOutFrame();
     myFrameGreyed = true;
   } else {
     endFrame();
@@ -719,6 +900,22 @@ uInt32 TIA::clocksThisLine() const
 void TIA::setSound(Sound& sound)
 {
   mySound = &sound;
+  mySoundConsumed = sound.isConsumed();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::computeMaskTables()
+{
+  for(uInt32 i = 0; i < 640; ++i)
+    ourDisabledMaskTable[i] = 0;
+
+  computeBallMaskTable();
+  computeCollisionTable();
+  computeMissleMaskTable();
+  computePlayerMaskTable();
+  computePlayerPositionResetWhenTable();
+  computePlayerReflectTable();
+  computePlayfieldMaskTable();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1219,6 +1416,9 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
   // Handle all other possible combinations
   else
   {
+    // The collisions are computed when they're read
+    recordCollisions(clocksToUpdate, hpos);
+
     switch(myEnabledObjects | myPlayfieldPriorityAndScore)
     {
       // Background 
@@ -1345,10 +1545,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = (myCurrentGRP0 & *mP0) ? 
                 myCOLUP0 : ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
-
-            if((myCurrentGRP0 & *mP0) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myP0Bit | myP1Bit];
-
             ++mP0; ++mP1; ++myFramePointer;
           }
         }
@@ -1446,10 +1642,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           else
           {
             *myFramePointer = *mM0 ? myCOLUP0 : (*mM1 ? myCOLUP1 : myCOLUBK);
-
-            if(*mM0 && *mM1)
-              myCollision |= ourCollisionTable[myM0Bit | myM1Bit];
-
             ++mM0; ++mM1; ++myFramePointer;
           }
         }
@@ -1473,10 +1665,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           else
           {
             *myFramePointer = (*mM0 ? myCOLUP0 : (*mBL ? myCOLUPF : myCOLUBK));
-
-            if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
-
             ++mBL; ++mM0; ++myFramePointer;
           }
         }
@@ -1500,10 +1688,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           else
           {
             *myFramePointer = (*mBL ? myCOLUPF : (*mM0 ? myCOLUP0 : myCOLUBK));
-
-            if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
-
             ++mBL; ++mM0; ++myFramePointer;
           }
         }
@@ -1528,10 +1712,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           else
           {
             *myFramePointer = (*mM1 ? myCOLUP1 : (*mBL ? myCOLUPF : myCOLUBK));
-
-            if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
-
             ++mBL; ++mM1; ++myFramePointer;
           }
         }
@@ -1556,10 +1736,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           else
           {
             *myFramePointer = (*mBL ? myCOLUPF : (*mM1 ? myCOLUP1 : myCOLUBK));
-
-            if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
-
             ++mBL; ++mM1; ++myFramePointer;
           }
         }
@@ -1584,10 +1760,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 : 
                 (*mBL ? myCOLUPF : myCOLUBK);
-
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
-
             ++mBL; ++mP1; ++myFramePointer;
           }
         }
@@ -1612,10 +1784,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = *mBL ? myCOLUPF : 
                 ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
-
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
-
             ++mBL; ++mP1; ++myFramePointer;
           }
         }
@@ -1639,10 +1807,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = (myCurrentGRP0 & *mP0) ? 
                   myCOLUP0 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK);
-
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
-
             ++mPF; ++mP0; ++myFramePointer;
           }
         }
@@ -1667,10 +1831,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = (myPF & *mPF) ? myCOLUPF : 
                 ((myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK);
-
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
-
             ++mPF; ++mP0; ++myFramePointer;
           }
         }
@@ -1695,10 +1855,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = (myCurrentGRP1 & *mP1) ? 
                   myCOLUP1 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK);
-
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
-
             ++mPF; ++mP1; ++myFramePointer;
           }
         }
@@ -1723,10 +1879,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           {
             *myFramePointer = (myPF & *mPF) ? myCOLUPF : 
                 ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
-
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
-
             ++mPF; ++mP1; ++myFramePointer;
           }
         }
@@ -1751,10 +1903,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           else
           {
             *myFramePointer = ((myPF & *mPF) || *mBL) ? myCOLUPF : myCOLUBK;
-
-            if((myPF & *mPF) && *mBL)
-              myCollision |= ourCollisionTable[myPFBit | myBLBit];
-
             ++mPF; ++mBL; ++myFramePointer;
           }
         }
@@ -1764,6 +1912,21 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
       // Handle all of the other cases
       default:
       {
+#ifdef TIA_X86_KERNELS
+        if(myVectorScanline && (clocksToUpdate >= 16))
+        {
+          ScanlineSegment segment;
+          currentSegment(segment, clocksToUpdate, hpos);
+
+          // The playfield and the players are drawn from their graphics
+          // whether or not their enabled bits are set
+          uInt16 collisions = 0;
+          uInt32 handled = updateSegmentVector(segment, myEnabledObjects |
+              myPFBit | myP0Bit | myP1Bit, myFramePointer, 0, collisions);
+          myFramePointer += handled;
+          hpos += handled;
+        }
+#endif
         for(; myFramePointer < ending; ++myFramePointer, ++hpos)
         {
           uInt8 enabled = (myPF & myCurrentPFMask[hpos]) ? myPFBit : 0;
@@ -1783,7 +1946,6 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
           if((myEnabledObjects & myM0Bit) && myCurrentM0Mask[hpos])
             enabled |= myM0Bit;
 
-          myCollision |= ourCollisionTable[enabled];
           *myFramePointer = myColor[myPriorityEncoder[hpos < 80 ? 0 : 1]
               [enabled | myPlayfieldPriorityAndScore]];
         }
@@ -1794,6 +1956,267 @@ inline void TIA::updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos)
   myFramePointer = ending;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void TIA::currentSegment(ScanlineSegment& segment,
+    uInt32 clocksToUpdate, uInt32 hpos) const
+{
+  segment.pfMask = myCurrentPFMask;
+  segment.p0Mask = myCurrentP0Mask;
+  segment.m0Mask = myCurrentM0Mask;
+  segment.p1Mask = myCurrentP1Mask;
+  segment.m1Mask = myCurrentM1Mask;
+  segment.blMask = myCurrentBLMask;
+  segment.pf = myPF;
+  segment.grp0 = myCurrentGRP0;
+  segment.grp1 = myCurrentGRP1;
+  segment.objects = myEnabledObjects;
+  segment.hpos = hpos;
+  segment.clocks = clocksToUpdate;
+  segment.pending = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void TIA::recordCollisions(uInt32 clocksToUpdate, uInt32 hpos)
+{
+  // Nothing can be set unless two of the objects are enabled
+  uInt16 pending = ourCollisionTable[myEnabledObjects & 0x3F] & ~myCollision;
+  if(pending == 0)
+    return;
+
+  // Writes to the other registers, such as the colors, split scanlines into
+  // segments whose objects are the same, so those are joined together
+  if(myCollisionSegmentCount != 0)
+  {
+    ScanlineSegment& last = myCollisionSegments[myCollisionSegmentCount - 1];
+
+    if((last.hpos + last.clocks == hpos) && (last.objects == myEnabledObjects) &&
+        (last.pf == myPF) && (last.pfMask == myCurrentPFMask) &&
+        (last.grp0 == myCurrentGRP0) && (last.p0Mask == myCurrentP0Mask) &&
+        (last.grp1 == myCurrentGRP1) && (last.p1Mask == myCurrentP1Mask) &&
+        (last.m0Mask == myCurrentM0Mask) && (last.m1Mask == myCurrentM1Mask) &&
+        (last.blMask == myCurrentBLMask))
+    {
+      last.clocks += clocksToUpdate;
+      last.pending |= pending;
+      return;
+    }
+  }
+
+  if(myCollisionSegmentCount == CollisionSegmentCapacity)
+    updateCollisions(0x7FFF);
+
+  ScanlineSegment& segment = myCollisionSegments[myCollisionSegmentCount++];
+  currentSegment(segment, clocksToUpdate, hpos);
+  segment.pending = pending;
+
+  // Without lazy_tia_collisions the segment is looked at right away, as if
+  // its collisions were set while it's drawn
+  if(!myLazyCollisions)
+    updateCollisions(0x7FFF);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateCollisions(uInt16 bits)
+{
+  // Latched collisions can't be cleared by the pending segments
+  if((bits & ~myCollision) == 0)
+    return;
+
+  // Look for all of the collisions at once, since most of the work of
+  // looking at a segment is shared between them
+  for(uInt32 i = 0; i < myCollisionSegmentCount; ++i)
+  {
+    uInt16 wanted = myCollisionSegments[i].pending & ~myCollision;
+    if(wanted != 0)
+      myCollision |= segmentCollisions(myCollisionSegments[i], wanted);
+  }
+
+  myCollisionSegmentCount = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 TIA::segmentCollisions(const ScanlineSegment& segment,
+    uInt16 bits) const
+{
+  // Only the objects of the wanted collisions need to be looked at
+  uInt8 objects = 0;
+  for(uInt8 object = myP0Bit; object <= myPFBit; object <<= 1)
+  {
+    if(bits & ~ourCollisionTable[0x3F & ~object])
+      objects |= object;
+  }
+  objects &= segment.objects;
+
+  uInt16 collisions = 0;
+  uInt32 hpos = segment.hpos;
+  uInt32 end = segment.hpos + segment.clocks;
+
+#ifdef TIA_X86_KERNELS
+  if(myVectorScanline)
+    hpos += updateSegmentVector(segment, objects, 0, bits, collisions);
+#endif
+
+  for(; (hpos < end) && ((collisions & bits) != bits); ++hpos)
+  {
+    uInt8 enabled = 0;
+
+    if((objects & myPFBit) && (segment.pf & segment.pfMask[hpos]))
+      enabled |= myPFBit;
+
+    if((objects & myBLBit) && segment.blMask[hpos])
+      enabled |= myBLBit;
+
+    if((objects & myP1Bit) && (segment.grp1 & segment.p1Mask[hpos]))
+      enabled |= myP1Bit;
+
+    if((objects & myM1Bit) && segment.m1Mask[hpos])
+      enabled |= myM1Bit;
+
+    if((objects & myP0Bit) && (segment.grp0 & segment.p0Mask[hpos]))
+      enabled |= myP0Bit;
+
+    if((objects & myM0Bit) && segment.m0Mask[hpos])
+      enabled |= myM0Bit;
+
+    collisions |= ourCollisionTable[enabled];
+  }
+
+  return collisions & bits;
+}
+
+#ifdef TIA_X86_KERNELS
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("ssse3")))
+uInt32 TIA::updateSegmentVector(const ScanlineSegment& segment, uInt8 objects,
+    uInt8* frame, uInt16 bits, uInt16& collisions) const
+{
+  // Loaded at (hpos - 64) this selects the pixels of a group of 16 which
+  // are on the left half of the screen
+  static const uInt8 leftHalfMask[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  };
+
+  // The priority encoder only tells apart player 0 or missle 0, player 1 or
+  // missle 1, the ball and the playfield.  This maps the low four bits of
+  // the enabled objects to the first two of those.
+  const __m128i playerKey = _mm_setr_epi8(0, 1, 1, 1, 2, 3, 3, 3,
+      2, 3, 3, 3, 2, 3, 3, 3);
+
+  // So a shuffle of the colors of those 16 combinations, for each half of
+  // the screen, gives the color of the pixels
+  __m128i leftColors = _mm_setzero_si128();
+  __m128i rightColors = _mm_setzero_si128();
+  if(frame != 0)
+  {
+    uInt8 colors[2][16];
+    for(uInt32 x = 0; x < 2; ++x)
+    {
+      for(uInt32 key = 0; key < 16; ++key)
+      {
+        uInt8 enabled = ((key & 0x01) ? myP0Bit : 0) |
+            ((key & 0x02) ? myP1Bit : 0) | ((key & 0x04) ? myBLBit : 0) |
+            ((key & 0x08) ? myPFBit : 0);
+
+        colors[x][key] = myColor[myPriorityEncoder[x]
+            [enabled | myPlayfieldPriorityAndScore]];
+      }
+    }
+    leftColors = _mm_loadu_si128((const __m128i*)colors[0]);
+    rightColors = _mm_loadu_si128((const __m128i*)colors[1]);
+  }
+
+  // Objects which aren't looked for are never found in a pixel
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi8((char)0xFF);
+  const __m128i pf = _mm_set1_epi32((objects & myPFBit) ? (int)segment.pf : 0);
+  const __m128i grp0 = _mm_set1_epi8((objects & myP0Bit) ? (char)segment.grp0 : 0);
+  const __m128i grp1 = _mm_set1_epi8((objects & myP1Bit) ? (char)segment.grp1 : 0);
+  const __m128i m0 = (objects & myM0Bit) ? ones : zero;
+  const __m128i m1 = (objects & myM1Bit) ? ones : zero;
+  const __m128i bl = (objects & myBLBit) ? ones : zero;
+
+  uInt32 hpos = segment.hpos;
+  uInt32 end = segment.hpos + (segment.clocks & ~0x0F);
+
+  for(uInt32 x = hpos; x < end; x += 16)
+  {
+    // Find the pixels where each object is absent
+    __m128i noP0 = _mm_cmpeq_epi8(_mm_and_si128(grp0,
+        _mm_loadu_si128((const __m128i*)&segment.p0Mask[x])), zero);
+    __m128i noM0 = _mm_cmpeq_epi8(_mm_and_si128(m0,
+        _mm_loadu_si128((const __m128i*)&segment.m0Mask[x])), zero);
+    __m128i noP1 = _mm_cmpeq_epi8(_mm_and_si128(grp1,
+        _mm_loadu_si128((const __m128i*)&segment.p1Mask[x])), zero);
+    __m128i noM1 = _mm_cmpeq_epi8(_mm_and_si128(m1,
+        _mm_loadu_si128((const __m128i*)&segment.m1Mask[x])), zero);
+    __m128i noBL = _mm_cmpeq_epi8(_mm_and_si128(bl,
+        _mm_loadu_si128((const __m128i*)&segment.blMask[x])), zero);
+
+    const __m128i* mPF = (const __m128i*)&segment.pfMask[x];
+    __m128i noPF = _mm_packs_epi16(
+        _mm_packs_epi32(
+            _mm_cmpeq_epi32(_mm_and_si128(pf, _mm_loadu_si128(mPF)), zero),
+            _mm_cmpeq_epi32(_mm_and_si128(pf, _mm_loadu_si128(mPF + 1)), zero)),
+        _mm_packs_epi32(
+            _mm_cmpeq_epi32(_mm_and_si128(pf, _mm_loadu_si128(mPF + 2)), zero),
+            _mm_cmpeq_epi32(_mm_and_si128(pf, _mm_loadu_si128(mPF + 3)), zero)));
+
+    // Combine them into the enabled objects of each pixel
+    __m128i enabled = _mm_or_si128(
+        _mm_or_si128(_mm_andnot_si128(noP0, _mm_set1_epi8(myP0Bit)),
+                     _mm_andnot_si128(noM0, _mm_set1_epi8(myM0Bit))),
+        _mm_or_si128(_mm_andnot_si128(noP1, _mm_set1_epi8(myP1Bit)),
+                     _mm_andnot_si128(noM1, _mm_set1_epi8(myM1Bit))));
+    enabled = _mm_or_si128(enabled, _mm_or_si128(
+        _mm_andnot_si128(noBL, _mm_set1_epi8(myBLBit)),
+        _mm_andnot_si128(noPF, _mm_set1_epi8(myPFBit))));
+
+    if(frame != 0)
+    {
+      __m128i key = _mm_or_si128(
+          _mm_shuffle_epi8(playerKey, _mm_and_si128(enabled, _mm_set1_epi8(0x0F))),
+          _mm_and_si128(_mm_srli_epi16(enabled, 2), _mm_set1_epi8(0x0C)));
+
+      __m128i color;
+      if(x + 16 <= 80)
+        color = _mm_shuffle_epi8(leftColors, key);
+      else if(x >= 80)
+        color = _mm_shuffle_epi8(rightColors, key);
+      else
+      {
+        __m128i left = _mm_loadu_si128((const __m128i*)&leftHalfMask[x - 64]);
+        color = _mm_or_si128(
+            _mm_and_si128(left, _mm_shuffle_epi8(leftColors, key)),
+            _mm_andnot_si128(left, _mm_shuffle_epi8(rightColors, key)));
+      }
+      _mm_storeu_si128((__m128i*)frame, color);
+      frame += 16;
+    }
+    else
+    {
+      // Only pixels with more than one object have collisions, which most
+      // groups of pixels don't
+      __m128i overlaps = _mm_and_si128(enabled, _mm_add_epi8(enabled, ones));
+      if(_mm_movemask_epi8(_mm_cmpeq_epi8(overlaps, zero)) != 0xFFFF)
+      {
+        uInt8 pixels[16];
+        _mm_storeu_si128((__m128i*)pixels, enabled);
+
+        for(uInt32 i = 0; i < 16; ++i)
+          collisions |= ourCollisionTable[pixels[i]];
+
+        if((collisions & bits) == bits)
+          return x + 16 - hpos;
+      }
+    }
+  }
+
+  return end - hpos;
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::updateFrame(Int32 clock)
 {
@@ -1871,7 +2294,9 @@ inline void TIA::updateFrame(Int32 clock)
         (clocksFromStartOfScanLine < (HBLANK + 8)))
     {
       Int32 blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
-      memset(oldFramePointer, 0, blanks);
+      // The frame buffer is not drawn into in fast mode
+      if(!fastUpdate)
+        memset(oldFramePointer, 0, blanks);
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
       {
@@ -1899,7 +2324,7 @@ inline void TIA::updateFrame(Int32 clock)
       if(myM0CosmicArkMotionEnabled)
       {
         // Movement table associated with the bug
-        static uInt32 m[4] = {18, 33, 0, 17};
+        static const uInt32 m[4] = {18, 33, 0, 17};
 
         myM0CosmicArkCounter = (myM0CosmicArkCounter + 1) & 3;
         myPOSM0 -= m[myM0CosmicArkCounter];
@@ -1979,33 +2404,41 @@ uInt8 TIA::peek(uInt16 addr)
   switch(addr & 0x000f)
   {
     case 0x00:    // CXM0P
+      updateCollisions(0x0003);
       return ((myCollision & 0x0001) ? 0x80 : 0x00) | 
           ((myCollision & 0x0002) ? 0x40 : 0x00) | noise;
 
     case 0x01:    // CXM1P
+      updateCollisions(0x000C);
       return ((myCollision & 0x0004) ? 0x80 : 0x00) | 
           ((myCollision & 0x0008) ? 0x40 : 0x00) | noise;
 
     case 0x02:    // CXP0FB
+      updateCollisions(0x0030);
       return ((myCollision & 0x0010) ? 0x80 : 0x00) | 
           ((myCollision & 0x0020) ? 0x40 : 0x00) | noise;
 
     case 0x03:    // CXP1FB
+      updateCollisions(0x00C0);
       return ((myCollision & 0x0040) ? 0x80 : 0x00) | 
           ((myCollision & 0x0080) ? 0x40 : 0x00) | noise;
 
     case 0x04:    // CXM0FB
+      updateCollisions(0x0300);
       return ((myCollision & 0x0100) ? 0x80 : 0x00) | 
           ((myCollision & 0x0200) ? 0x40 : 0x00) | noise;
 
     case 0x05:    // CXM1FB
+      updateCollisions(0x0C00);
       return ((myCollision & 0x0400) ? 0x80 : 0x00) | 
           ((myCollision & 0x0800) ? 0x40 : 0x00) | noise;
 
     case 0x06:    // CXBLPF
+      updateCollisions(0x1000);
       return ((myCollision & 0x1000) ? 0x80 : 0x00) | noise;
 
     case 0x07:    // CXPPMM
+      updateCollisions(0x6000);
       return ((myCollision & 0x2000) ? 0x80 : 0x00) | 
           ((myCollision & 0x4000) ? 0x40 : 0x00) | noise;
 
@@ -2140,7 +2573,7 @@ void TIA::poke(uInt16 addr, uInt8 value)
   // See if this is a poke to a PF register
   if(delay == -1)
   {
-    static uInt32 d[4] = {4, 5, 2, 3};
+    static const uInt32 d[4] = {4, 5, 2, 3};
     Int32 x = ((clock - myClockWhenFrameStarted) % 228);
     delay = d[(x / 3) & 3];
   }
@@ -2545,42 +2978,48 @@ void TIA::poke(uInt16 addr, uInt8 value)
     case 0x15:    // Audio control 0
     {
       myAUDC0 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundConsumed)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
   
     case 0x16:    // Audio control 1
     {
       myAUDC1 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundConsumed)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
   
     case 0x17:    // Audio frequency 0
     {
       myAUDF0 = value & 0x1f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundConsumed)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
   
     case 0x18:    // Audio frequency 1
     {
       myAUDF1 = value & 0x1f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundConsumed)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
   
     case 0x19:    // Audio volume 0
     {
       myAUDV0 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundConsumed)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
   
     case 0x1A:    // Audio volume 1
     {
       myAUDV1 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundConsumed)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
@@ -2896,6 +3335,7 @@ void TIA::poke(uInt16 addr, uInt8 value)
     case 0x2c:    // Clear collision latches
     {
       myCollision = 0;
+      myCollisionSegmentCount = 0;
       break;
     }
 
@@ -3038,6 +3478,7 @@ TIA::TIA(const TIA& c)
     : myConsole(c.myConsole),
       mySettings(c.mySettings),
       mySound(c.mySound),
+      mySoundConsumed(c.mySoundConsumed),
       myCOLUBK(myColor[0]),
       myCOLUPF(myColor[1]),
       myCOLUP0(myColor[2]),
@@ -3058,596 +3499,12 @@ TIA& TIA::operator = (const TIA&)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::updateFrameScanlineFast(uInt32 clocksToUpdate, uInt32 hpos)
 {
-  // Calculate the ending frame pointer value
-  uInt8* ending = myFramePointer + clocksToUpdate;
-
-  // See if we're in the vertical blank region
-  if(myVBLANK & 0x02)
+  // Nothing is drawn, and the collisions are computed when they're read
+  if(!(myVBLANK & 0x02))
   {
-    // @strip memset(myFramePointer, 0, clocksToUpdate);
+    recordCollisions(clocksToUpdate, hpos);
   }
-  // Handle all other possible combinations
-  else
-  {
-    switch(myEnabledObjects | myPlayfieldPriorityAndScore)
-    {
-      // Background 
-      case 0x00:
-      case 0x00 | ScoreBit:
-      case 0x00 | PriorityBit:
-      case 0x00 | PriorityBit | ScoreBit:
-      /* @strip {
-        memset(myFramePointer, myCOLUBK, clocksToUpdate);
-        break;
-      } */
-      break;
-
-      // Playfield is enabled and the score bit is not set
-      case myPFBit: 
-      case myPFBit | PriorityBit:
-      /* @strip
-      {
-        uInt32* mask = &myCurrentPFMask[hpos];
-
-        // Update a uInt8 at a time until reaching a uInt32 boundary
-        for(; ((uintptr_t)myFramePointer & 0x03) && (myFramePointer < ending);
-            ++myFramePointer, ++mask)
-        {
-          *myFramePointer = (myPF & *mask) ? myCOLUPF : myCOLUBK;
-        }
-
-        // Now, update a uInt32 at a time
-        for(; myFramePointer < ending; myFramePointer += 4, mask += 4)
-        {
-          *((uInt32*)myFramePointer) = (myPF & *mask) ? myCOLUPF : myCOLUBK;
-        }
-        break;
-      } */ break;
-
-      // Playfield is enabled and the score bit is set
-      case myPFBit | ScoreBit:
-      case myPFBit | ScoreBit | PriorityBit:
-      /* @strip {
-        uInt32* mask = &myCurrentPFMask[hpos];
-
-        // Update a uInt8 at a time until reaching a uInt32 boundary
-        for(; ((uintptr_t)myFramePointer & 0x03) && (myFramePointer < ending); 
-            ++myFramePointer, ++mask, ++hpos)
-        {
-          *myFramePointer = (myPF & *mask) ? 
-              (hpos < 80 ? myCOLUP0 : myCOLUP1) : myCOLUBK;
-        }
-
-        // Now, update a uInt32 at a time
-        for(; myFramePointer < ending; 
-            myFramePointer += 4, mask += 4, hpos += 4)
-        {
-          *((uInt32*)myFramePointer) = (myPF & *mask) ?
-              (hpos < 80 ? myCOLUP0 : myCOLUP1) : myCOLUBK;
-        }
-        break;
-      } */
-      break;
-
-      // Player 0 is enabled
-      case myP0Bit:
-      case myP0Bit | ScoreBit:
-      case myP0Bit | PriorityBit:
-      case myP0Bit | ScoreBit | PriorityBit:
-      /* @strip {
-        uInt8* mP0 = &myCurrentP0Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP0)
-          {
-            *(uInt32*)myFramePointer = myCOLUBK;
-            mP0 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            *myFramePointer = (myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK;
-            ++mP0; ++myFramePointer;
-          }
-        }
-        break;
-      } */
-
-      // Player 1 is enabled
-      case myP1Bit:
-      case myP1Bit | ScoreBit:
-      case myP1Bit | PriorityBit:
-      case myP1Bit | ScoreBit | PriorityBit:
-      /* @strip {
-        uInt8* mP1 = &myCurrentP1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP1)
-          {
-            *(uInt32*)myFramePointer = myCOLUBK;
-            mP1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK;
-            ++mP1; ++myFramePointer;
-          }
-        }
-        break;
-      } */
 
-      // Player 0 and 1 are enabled
-      case myP0Bit | myP1Bit:
-      case myP0Bit | myP1Bit | ScoreBit:
-      case myP0Bit | myP1Bit | PriorityBit:
-      case myP0Bit | myP1Bit | ScoreBit | PriorityBit:
-      {
-        uInt8* mP0 = &myCurrentP0Mask[hpos];
-        uInt8* mP1 = &myCurrentP1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP0 &&
-              !*(uInt32*)mP1)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mP0 += 4; mP1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = (myCurrentGRP0 & *mP0) ? 
-                myCOLUP0 : ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
-            */
-
-            if((myCurrentGRP0 & *mP0) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myP0Bit | myP1Bit];
-
-            ++mP0; ++mP1; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Missle 0 is enabled
-      case myM0Bit:
-      case myM0Bit | ScoreBit:
-      case myM0Bit | PriorityBit:
-      case myM0Bit | ScoreBit | PriorityBit:
-      /* @strip {
-        uInt8* mM0 = &myCurrentM0Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mM0)
-          {
-            *(uInt32*)myFramePointer = myCOLUBK;
-            mM0 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            *myFramePointer = *mM0 ? myCOLUP0 : myCOLUBK;
-            ++mM0; ++myFramePointer;
-          }
-        }
-        break; 
-      } */
-      break;
-
-      // Missle 1 is enabled
-      case myM1Bit:
-      case myM1Bit | ScoreBit:
-      case myM1Bit | PriorityBit:
-      case myM1Bit | ScoreBit | PriorityBit:
-      /* @strip {
-        uInt8* mM1 = &myCurrentM1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mM1)
-          {
-            *(uInt32*)myFramePointer = myCOLUBK;
-            mM1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            *myFramePointer = *mM1 ? myCOLUP1 : myCOLUBK;
-            ++mM1; ++myFramePointer;
-          }
-        }
-        break;
-      } */ 
-      break;
-
-      // Ball is enabled
-      case myBLBit:
-      case myBLBit | ScoreBit:
-      case myBLBit | PriorityBit:
-      case myBLBit | ScoreBit | PriorityBit:
-      /* @strip {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mBL)
-          {
-            *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; myFramePointer += 4;
-          }
-          else
-          {
-            *myFramePointer = *mBL ? myCOLUPF : myCOLUBK;
-            ++mBL; ++myFramePointer;
-          }
-        }
-        break;
-      } */
-      break;
-
-      // Missle 0 and 1 are enabled
-      case myM0Bit | myM1Bit:
-      case myM0Bit | myM1Bit | ScoreBit:
-      case myM0Bit | myM1Bit | PriorityBit:
-      case myM0Bit | myM1Bit | ScoreBit | PriorityBit:
-      {
-        uInt8* mM0 = &myCurrentM0Mask[hpos];
-        uInt8* mM1 = &myCurrentM1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mM0 && !*(uInt32*)mM1)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mM0 += 4; mM1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            // @strip *myFramePointer = *mM0 ? myCOLUP0 : (*mM1 ? myCOLUP1 : myCOLUBK);
-
-            if(*mM0 && *mM1)
-              myCollision |= ourCollisionTable[myM0Bit | myM1Bit];
-
-            ++mM0; ++mM1; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Ball and Missle 0 are enabled and playfield priority is not set
-      case myBLBit | myM0Bit:
-      case myBLBit | myM0Bit | ScoreBit:
-      {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-        uInt8* mM0 = &myCurrentM0Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mBL && !*(uInt32*)mM0)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; mM0 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            // @strip *myFramePointer = (*mM0 ? myCOLUP0 : (*mBL ? myCOLUPF : myCOLUBK));
-
-            if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
-
-            ++mBL; ++mM0; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Ball and Missle 0 are enabled and playfield priority is set
-      case myBLBit | myM0Bit | PriorityBit:
-      case myBLBit | myM0Bit | ScoreBit | PriorityBit:
-      {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-        uInt8* mM0 = &myCurrentM0Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mBL && !*(uInt32*)mM0)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; mM0 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            // @strip *myFramePointer = (*mBL ? myCOLUPF : (*mM0 ? myCOLUP0 : myCOLUBK));
-
-            if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
-
-            ++mBL; ++mM0; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Ball and Missle 1 are enabled and playfield priority is not set
-      case myBLBit | myM1Bit:
-      case myBLBit | myM1Bit | ScoreBit:
-      {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-        uInt8* mM1 = &myCurrentM1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mBL && 
-              !*(uInt32*)mM1)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; mM1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            // @strip *myFramePointer = (*mM1 ? myCOLUP1 : (*mBL ? myCOLUPF : myCOLUBK));
-
-            if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
-
-            ++mBL; ++mM1; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Ball and Missle 1 are enabled and playfield priority is set
-      case myBLBit | myM1Bit | PriorityBit:
-      case myBLBit | myM1Bit | ScoreBit | PriorityBit:
-      {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-        uInt8* mM1 = &myCurrentM1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mBL && 
-              !*(uInt32*)mM1)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; mM1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            // @strip *myFramePointer = (*mBL ? myCOLUPF : (*mM1 ? myCOLUP1 : myCOLUBK));
-
-            if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
-
-            ++mBL; ++mM1; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Ball and Player 1 are enabled and playfield priority is not set
-      case myBLBit | myP1Bit:
-      case myBLBit | myP1Bit | ScoreBit:
-      {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-        uInt8* mP1 = &myCurrentP1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP1 && !*(uInt32*)mBL)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; mP1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 : 
-                (*mBL ? myCOLUPF : myCOLUBK); */
-
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
-
-            ++mBL; ++mP1; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Ball and Player 1 are enabled and playfield priority is set
-      case myBLBit | myP1Bit | PriorityBit:
-      case myBLBit | myP1Bit | PriorityBit | ScoreBit:
-      {
-        uInt8* mBL = &myCurrentBLMask[hpos];
-        uInt8* mP1 = &myCurrentP1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP1 && !*(uInt32*)mBL)
-          {
-            // @strip *(uInt32*)myFramePointer = myCOLUBK;
-            mBL += 4; mP1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = *mBL ? myCOLUPF : 
-                ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK); */
-
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
-
-            ++mBL; ++mP1; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Playfield and Player 0 are enabled and playfield priority is not set
-      case myPFBit | myP0Bit:
-      {
-        uInt32* mPF = &myCurrentPFMask[hpos];
-        uInt8* mP0 = &myCurrentP0Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP0)
-          {
-            // @strip *(uInt32*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
-            mPF += 4; mP0 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = (myCurrentGRP0 & *mP0) ? 
-                  myCOLUP0 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK); */
-
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
-
-            ++mPF; ++mP0; ++myFramePointer;
-          }
-        }
-
-        break;
-      }
-
-      // Playfield and Player 0 are enabled and playfield priority is set
-      case myPFBit | myP0Bit | PriorityBit:
-      {
-        uInt32* mPF = &myCurrentPFMask[hpos];
-        uInt8* mP0 = &myCurrentP0Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP0)
-          {
-            // @strip *(uInt32*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
-            mPF += 4; mP0 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = (myPF & *mPF) ? myCOLUPF : 
-                ((myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK); */
-
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
-
-            ++mPF; ++mP0; ++myFramePointer;
-          }
-        }
-
-        break;
-      }
-
-      // Playfield and Player 1 are enabled and playfield priority is not set
-      case myPFBit | myP1Bit:
-      {
-        uInt32* mPF = &myCurrentPFMask[hpos];
-        uInt8* mP1 = &myCurrentP1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP1)
-          {
-            // @strip *(uInt32*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
-            mPF += 4; mP1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = (myCurrentGRP1 & *mP1) ? 
-                  myCOLUP1 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK); */ 
-
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
-
-            ++mPF; ++mP1; ++myFramePointer;
-          }
-        }
-
-        break;
-      }
-
-      // Playfield and Player 1 are enabled and playfield priority is set
-      case myPFBit | myP1Bit | PriorityBit:
-      {
-        uInt32* mPF = &myCurrentPFMask[hpos];
-        uInt8* mP1 = &myCurrentP1Mask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mP1)
-          {
-            // @strip *(uInt32*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
-            mPF += 4; mP1 += 4; myFramePointer += 4;
-          }
-          else
-          {
-            /* @strip *myFramePointer = (myPF & *mPF) ? myCOLUPF : 
-                ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK); */
-
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
-
-            ++mPF; ++mP1; ++myFramePointer;
-          }
-        }
-
-        break;
-      }
-
-      // Playfield and Ball are enabled
-      case myPFBit | myBLBit:
-      case myPFBit | myBLBit | PriorityBit:
-      {
-        uInt32* mPF = &myCurrentPFMask[hpos];
-        uInt8* mBL = &myCurrentBLMask[hpos];
-
-        while(myFramePointer < ending)
-        {
-          if(!((uintptr_t)myFramePointer & 0x03) && !*(uInt32*)mBL)
-          {
-            // @strip *(uInt32*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
-            mPF += 4; mBL += 4; myFramePointer += 4;
-          }
-          else
-          {
-            // @strip *myFramePointer = ((myPF & *mPF) || *mBL) ? myCOLUPF : myCOLUBK;
-
-            if((myPF & *mPF) && *mBL)
-              myCollision |= ourCollisionTable[myPFBit | myBLBit];
-
-            ++mPF; ++mBL; ++myFramePointer;
-          }
-        }
-        break;
-      }
-
-      // Handle all of the other cases
-      default:
-      {
-        for(; myFramePointer < ending; ++myFramePointer, ++hpos)
-        {
-          uInt8 enabled = (myPF & myCurrentPFMask[hpos]) ? myPFBit : 0;
-
-          if((myEnabledObjects & myBLBit) && myCurrentBLMask[hpos])
-            enabled |= myBLBit;
-
-          if(myCurrentGRP1 & myCurrentP1Mask[hpos])
-            enabled |= myP1Bit;
-
-          if((myEnabledObjects & myM1Bit) && myCurrentM1Mask[hpos])
-            enabled |= myM1Bit;
-
-          if(myCurrentGRP0 & myCurrentP0Mask[hpos])
-            enabled |= myP0Bit;
-
-          if((myEnabledObjects & myM0Bit) && myCurrentM0Mask[hpos])
-            enabled |= myM0Bit;
-
-          myCollision |= ourCollisionTable[enabled];
-          /* @strip *myFramePointer = myColor[myPriorityEncoder[hpos < 80 ? 0 : 1]
-              [enabled | myPlayfieldPriorityAndScore]]; */
-        }
-        break;  
-      }
-    }
-  }
-  myFramePointer = ending;
+  myFramePointer += clocksToUpdate;
 }
 
@@ -111,6 +111,14 @@ class TIA : public Device , public MediaSource
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Snapshot the TIA registers, followed by the state of the sound
+      device.  See Device::saveSnapshot().
+    */
+    virtual uInt32 snapshotSize();
+    virtual void saveSnapshot(uInt8* block);
+    virtual void loadSnapshot(const uInt8* block);
+
   public:
     /**
       Get the byte at the specified address
@@ -234,31 +242,42 @@ class TIA : public Device , public MediaSource
 #endif
 
   private:
+    // Compute all of the static tables; this is done once per process
+    static void computeMaskTables();
+
     // Compute the ball mask table
-    void computeBallMaskTable();
+    static void computeBallMaskTable();
 
     // Compute the collision decode table
-    void computeCollisionTable();
+    static void computeCollisionTable();
 
     // Compute the missle mask table
-    void computeMissleMaskTable();
+    static void computeMissleMaskTable();
 
     // Compute the player mask table
-    void computePlayerMaskTable();
+    static void computePlayerMaskTable();
 
     // Compute the player position reset when table
-    void computePlayerPositionResetWhenTable();
+    static void computePlayerPositionResetWhenTable();
 
     // Compute the player reflect table
-    void computePlayerReflectTable();
+    static void computePlayerReflectTable();
 
     // Compute playfield mask table
-    void computePlayfieldMaskTable();
+    static void computePlayfieldMaskTable();
 
   private:
     // Update the current frame buffer up to one scanline
     void updateFrameScanline(uInt32 clocksToUpdate, uInt32 hpos);
-   
+
+    // Remember the objects of a scanline segment which may collide, so the
+    // collision register can be updated when it's read
+    void recordCollisions(uInt32 clocksToUpdate, uInt32 hpos);
+
+    // Update the collision register from the recorded scanline segments,
+    // unless the given bits of it are all set already
+    void updateCollisions(uInt16 bits);
+
     // Update the current frame buffer to the specified color clock
     void updateFrame(Int32 clock);
 
@@ -287,6 +306,9 @@ class TIA : public Device , public MediaSource
     // Sound object the TIA is associated with
     Sound* mySound;
 
+    // Indicates if the sound object plays or records the audio registers
+    bool mySoundConsumed;
+
   private:
     // Indicates if color loss should be enabled or disabled.  Color loss
     // occurs on PAL (and maybe SECAM) systems when the previous frame
@@ -433,6 +455,46 @@ class TIA : public Device , public MediaSource
 
     uInt16 myCollision;    // Collision register
 
+    // The objects drawn in a scanline segment, which is a part of a
+    // scanline without register writes
+    struct ScanlineSegment
+    {
+      const uInt32* pfMask;
+      const uInt8* p0Mask;
+      const uInt8* m0Mask;
+      const uInt8* p1Mask;
+      const uInt8* m1Mask;
+      const uInt8* blMask;
+      uInt32 pf;
+      uInt8 grp0;
+      uInt8 grp1;
+      uInt8 objects;        // Enabled object bits
+      uInt8 hpos;           // Horizontal position of the first pixel
+      uInt8 clocks;         // Number of pixels in the segment
+      uInt16 pending;       // Collision bits not looked for yet
+    };
+
+    // Describe the scanline segment about to be drawn
+    void currentSegment(ScanlineSegment& segment, uInt32 clocksToUpdate,
+        uInt32 hpos) const;
+
+    // Answer which of the given collision bits the objects of the segment set
+    uInt16 segmentCollisions(const ScanlineSegment& segment, uInt16 bits) const;
+
+    // Find the given objects in the pixels of a segment 16 at a time with SIMD
+    // instructions, and draw them into frame unless it's null, or else add
+    // the given collision bits they set to collisions; answers how many
+    // pixels were handled (x86 builds only)
+    uInt32 updateSegmentVector(const ScanlineSegment& segment, uInt8 objects,
+        uInt8* frame, uInt16 bits, uInt16& collisions) const;
+
+    // Segments drawn since the collision latches were cleared which may
+    // still set some of them; the collision register is only computed
+    // from these when it's read, since most games seldom read it
+    enum { CollisionSegmentCapacity = 1024 };
+    ScanlineSegment myCollisionSegments[CollisionSegmentCapacity];
+    uInt32 myCollisionSegmentCount;
+
     // Note that these position registers contain the color clock 
     // on which the object's serial output should begin (0 to 159)
     Int16 myPOSP0;         // Player 0 position register
@@ -509,6 +571,40 @@ class TIA : public Device , public MediaSource
      // Has current frame been "greyed out" (has updateScanline() been run?)
      bool myFrameGreyed;
 
+    // Layout of the registers in a snapshot block
+    struct Snapshot
+    {
+      Int32 clockWhenFrameStarted;
+      Int32 clockStartDisplay;
+      Int32 clockStopDisplay;
+      Int32 clockAtLastUpdate;
+      Int32 clocksToEndOfScanLine;
+      Int32 scanlineCountForLastFrame;
+      Int32 currentScanline;
+      Int32 VSYNCFinishClock;
+      uInt32 COLUP0, COLUP1, COLUPF, COLUBK;
+      uInt32 PF;
+      Int32 lastHMOVEClock;
+      uInt32 M0CosmicArkCounter;
+      Int32 dumpDisabledCycle;
+      uInt16 collision;
+      Int16 POSP0, POSP1, POSM0, POSM1, POSBL;
+      uInt8 enabledObjects;
+      uInt8 VSYNC, VBLANK;
+      uInt8 NUSIZ0, NUSIZ1;
+      uInt8 CTRLPF, playfieldPriorityAndScore;
+      uInt8 GRP0, GRP1, DGRP0, DGRP1;
+      uInt8 currentGRP0, currentGRP1;
+      Int8 HMP0, HMP1, HMM0, HMM1, HMBL;
+      bool REFP0, REFP1;
+      bool ENAM0, ENAM1, ENABL, DENABL;
+      bool VDELP0, VDELP1, VDELBL;
+      bool RESMP0, RESMP1;
+      bool HMOVEBlankEnabled;
+      bool M0CosmicArkMotionEnabled;
+      bool dumpEnabled;
+    };
+
   private:
     // Ball mask table (entries are true or false)
     static uInt8 ourBallMaskTable[4][4][320];
@@ -552,8 +648,22 @@ class TIA : public Device , public MediaSource
     TIA& operator = (const TIA&);
 
   /** ALE-specific */
+  public:
+    /**
+      Enables or disables drawing into the frame buffer; see MediaSource.
+    */
+    void setRendering(bool render) { fastUpdate = !render; }
+
   private:
+    // Whether the frame buffer is left undrawn (fast_tia_update); collisions are still computed
     bool fastUpdate;
+
+    // Whether scanline segments are drawn with SSSE3 (vector_tia_update, where supported)
+    bool myVectorScanline;
+
+    // Whether collisions are computed when they're read rather than when
+    // they're drawn (lazy_tia_collisions)
+    bool myLazyCollisions;
    
     // Updates the frame's scanline but not the frame buffer 
     void updateFrameScanlineFast(uInt32 clocksToUpdate, uInt32 hpos);
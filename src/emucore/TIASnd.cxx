@@ -19,6 +19,7 @@
 #include "System.hxx"
 #include "TIASnd.hxx"
 #include <cassert>
+#include <cstring>
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIASound::TIASound(Int32 outputFrequency, Int32 tiaFrequency, uInt32 channels)
@@ -27,7 +28,8 @@ TIASound::TIASound(Int32 outputFrequency, Int32 tiaFrequency, uInt32 channels)
     myChannels(channels),
     myOutputCounter(0),
     myVolumePercentage(100),
-    myVolumeClip(128)
+    myVolumeClip(128),
+    myBatchProcessing(true)
 {
   reset();
 }
@@ -71,6 +73,12 @@ void TIASound::clipVolume(bool clip)
   myVolumeClip = clip ? 128 : 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::batchProcessing(bool enable)
+{
+  myBatchProcessing = enable;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::set(uInt16 address, uInt8 value)
 {
@@ -143,9 +151,217 @@ void TIASound::volume(uInt32 percent)
     myVolumePercentage = percent;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::clockPolynomials(uInt32 c)
+{
+  switch(myAUDC[c])
+  {
+    case 0x00:    // Set to 1
+    {
+      // Shift a 1 into the 4-bit register each clock
+      myP4[c] = (myP4[c] << 1) | 0x01;
+      break;
+    }
+
+    case 0x01:    // 4 bit poly
+    {
+      // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
+      myP4[c] = (myP4[c] & 0x0f) ? 
+          ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
+          ((myP4[c] & 0x04) ? 1 : 0))) : 1;
+      break;
+    }
+
+    case 0x02:    // div 31 -> 4 bit poly
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((myP5[c] & 0x0f) == 0x08)
+      {
+        // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
+        myP4[c] = (myP4[c] & 0x0f) ? 
+            ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
+            ((myP4[c] & 0x04) ? 1 : 0))) : 1;
+      }
+      break;
+    }
+
+    case 0x03:    // 5 bit poly -> 4 bit poly
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // P5 clocks the 4 bit poly
+      if(myP5[c] & 0x10)
+      {
+        // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
+        myP4[c] = (myP4[c] & 0x0f) ? 
+            ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
+            ((myP4[c] & 0x04) ? 1 : 0))) : 1;
+      }
+      break;
+    }
+
+    case 0x04:    // div 2
+    {
+      // Clock P4 toggling the lower bit (divide by 2) 
+      myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
+      break;
+    }
+
+    case 0x05:    // div 2
+    {
+      // Clock P4 toggling the lower bit (divide by 2) 
+      myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
+      break;
+    }
+
+    case 0x06:    // div 31 -> div 2
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((myP5[c] & 0x0f) == 0x08)
+      {
+        // Clock P4 toggling the lower bit (divide by 2) 
+        myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
+      }
+      break;
+    }
+
+    case 0x07:    // 5 bit poly -> div 2
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // P5 clocks the 4 bit register
+      if(myP5[c] & 0x10)
+      {
+        // Clock P4 toggling the lower bit (divide by 2) 
+        myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
+      }
+      break;
+    }
+
+    case 0x08:    // 9 bit poly
+    {
+      // Clock P5 & P4 as a standard 9-bit LSFR taps at 8 & 4
+      myP5[c] = ((myP5[c] & 0x1f) || (myP4[c] & 0x0f)) ?
+        ((myP5[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
+        ((myP5[c] & 0x10) ? 1 : 0))) : 1;
+      myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x20) ? 1 : 0);
+      break;
+    }
+
+    case 0x09:    // 5 bit poly
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // Clock value out of P5 into P4 with no modification
+      myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x20) ? 1 : 0);
+      break;
+    }
+
+    case 0x0a:    // div 31
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((myP5[c] & 0x0f) == 0x08)
+      {
+        // Feed bit 4 of P5 into P4 (this will toggle back and forth)
+        myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x10) ? 1 : 0);
+      }
+      break;
+    }
+
+    case 0x0b:    // Set last 4 bits to 1
+    {
+      // A 1 is shifted into the 4-bit register each clock
+      myP4[c] = (myP4[c] << 1) | 0x01;
+      break;
+    }
+
+    case 0x0c:    // div 6
+    {
+      // Use 4-bit register to generate sequence 000111000111
+      myP4[c] = (~myP4[c] << 1) |
+          ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
+      break;
+    }
+
+    case 0x0d:    // div 6
+    {
+      // Use 4-bit register to generate sequence 000111000111
+      myP4[c] = (~myP4[c] << 1) |
+          ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
+      break;
+    }
+
+    case 0x0e:    // div 31 -> div 6
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((myP5[c] & 0x0f) == 0x08)
+      {
+        // Use 4-bit register to generate sequence 000111000111
+        myP4[c] = (~myP4[c] << 1) |
+            ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
+      }
+      break;
+    }
+
+    case 0x0f:    // poly 5 -> div 6
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      myP5[c] = (myP5[c] & 0x1f) ?
+        ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
+        ((myP5[c] & 0x04) ? 1 : 0))) : 1;
+
+      // Use poly 5 to clock 4-bit div register
+      if(myP5[c] & 0x10)
+      {
+        // Use 4-bit register to generate sequence 000111000111
+        myP4[c] = (~myP4[c] << 1) |
+            ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
+      }
+      break;
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::process(uInt8* buffer, uInt32 samples)
 {
+  // When every TIA clock produces exactly one sample the channels can be
+  // generated a batch at a time
+  if(myBatchProcessing && (myOutputFrequency == myTIAFrequency))
+  {
+    processBatch(buffer, samples);
+    return;
+  }
+
   Int32 v0 = ((myAUDV[0] << 2) * myVolumePercentage) / 100;
   Int32 v1 = ((myAUDV[1] << 2) * myVolumePercentage) / 100;
 
@@ -156,204 +372,8 @@ void TIASound::process(uInt8* buffer, uInt32 samples)
     for(uInt32 c = 0; c < 2; ++c)
     {
       // Update P4 & P5 registers for channel if freq divider outputs a pulse
-      if((myFreqDiv[c].clock()))
-      {
-        switch(myAUDC[c])
-        {
-          case 0x00:    // Set to 1
-          {
-            // Shift a 1 into the 4-bit register each clock
-            myP4[c] = (myP4[c] << 1) | 0x01;
-            break;
-          }
-
-          case 0x01:    // 4 bit poly
-          {
-            // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
-            myP4[c] = (myP4[c] & 0x0f) ? 
-                ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-                ((myP4[c] & 0x04) ? 1 : 0))) : 1;
-            break;
-          }
-
-          case 0x02:    // div 31 -> 4 bit poly
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
-              myP4[c] = (myP4[c] & 0x0f) ? 
-                  ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-                  ((myP4[c] & 0x04) ? 1 : 0))) : 1;
-            }
-            break;
-          }
-
-          case 0x03:    // 5 bit poly -> 4 bit poly
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // P5 clocks the 4 bit poly
-            if(myP5[c] & 0x10)
-            {
-              // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
-              myP4[c] = (myP4[c] & 0x0f) ? 
-                  ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-                  ((myP4[c] & 0x04) ? 1 : 0))) : 1;
-            }
-            break;
-          }
-
-          case 0x04:    // div 2
-          {
-            // Clock P4 toggling the lower bit (divide by 2) 
-            myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            break;
-          }
-
-          case 0x05:    // div 2
-          {
-            // Clock P4 toggling the lower bit (divide by 2) 
-            myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            break;
-          }
-
-          case 0x06:    // div 31 -> div 2
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Clock P4 toggling the lower bit (divide by 2) 
-              myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            }
-            break;
-          }
-
-          case 0x07:    // 5 bit poly -> div 2
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // P5 clocks the 4 bit register
-            if(myP5[c] & 0x10)
-            {
-              // Clock P4 toggling the lower bit (divide by 2) 
-              myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            }
-            break;
-          }
-
-          case 0x08:    // 9 bit poly
-          {
-            // Clock P5 & P4 as a standard 9-bit LSFR taps at 8 & 4
-            myP5[c] = ((myP5[c] & 0x1f) || (myP4[c] & 0x0f)) ?
-              ((myP5[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-              ((myP5[c] & 0x10) ? 1 : 0))) : 1;
-            myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x20) ? 1 : 0);
-            break;
-          }
-
-          case 0x09:    // 5 bit poly
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // Clock value out of P5 into P4 with no modification
-            myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x20) ? 1 : 0);
-            break;
-          }
-
-          case 0x0a:    // div 31
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Feed bit 4 of P5 into P4 (this will toggle back and forth)
-              myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x10) ? 1 : 0);
-            }
-            break;
-          }
-
-          case 0x0b:    // Set last 4 bits to 1
-          {
-            // A 1 is shifted into the 4-bit register each clock
-            myP4[c] = (myP4[c] << 1) | 0x01;
-            break;
-          }
-
-          case 0x0c:    // div 6
-          {
-            // Use 4-bit register to generate sequence 000111000111
-            myP4[c] = (~myP4[c] << 1) |
-                ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            break;
-          }
-
-          case 0x0d:    // div 6
-          {
-            // Use 4-bit register to generate sequence 000111000111
-            myP4[c] = (~myP4[c] << 1) |
-                ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            break;
-          }
-
-          case 0x0e:    // div 31 -> div 6
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Use 4-bit register to generate sequence 000111000111
-              myP4[c] = (~myP4[c] << 1) |
-                  ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            }
-            break;
-          }
-
-          case 0x0f:    // poly 5 -> div 6
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // Use poly 5 to clock 4-bit div register
-            if(myP5[c] & 0x10)
-            {
-              // Use 4-bit register to generate sequence 000111000111
-              myP4[c] = (~myP4[c] << 1) |
-                  ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            }
-            break;
-          }
-        }
-      }
+      if(myFreqDiv[c].clock())
+        clockPolynomials(c);
     }
 
     myOutputCounter += myOutputFrequency;
@@ -382,3 +402,65 @@ void TIASound::process(uInt8* buffer, uInt32 samples)
     }
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::processBatch(uInt8* buffer, uInt32 samples)
+{
+  uInt8 volume[2];
+  volume[0] = ((myAUDV[0] << 2) * myVolumePercentage) / 100;
+  volume[1] = ((myAUDV[1] << 2) * myVolumePercentage) / 100;
+
+  // The output level of each channel for the current batch of samples
+  uInt8 level[2][BatchSize];
+
+  while(samples > 0)
+  {
+    uInt32 count = (samples < BatchSize) ? samples : BatchSize;
+
+    for(uInt32 c = 0; c < 2; ++c)
+    {
+      // A channel's output only changes when its frequency divider pulses,
+      // so it is constant for the clocks up to the next pulse
+      uInt8* out = level[c];
+      uInt32 left = count;
+      while(left > 0)
+      {
+        uInt8 current = (myP4[c] & 8) ? volume[c] : 0;
+        uInt32 clocks = myFreqDiv[c].clocksUntilPulse();
+        if(clocks > left)
+        {
+          memset(out, current, left);
+          myFreqDiv[c].skip(left);
+          break;
+        }
+
+        memset(out, current, clocks - 1);
+        myFreqDiv[c].skip(clocks - 1);
+        myFreqDiv[c].clock();
+        clockPolynomials(c);
+        out[clocks - 1] = (myP4[c] & 8) ? volume[c] : 0;
+
+        out += clocks;
+        left -= clocks;
+      }
+    }
+
+    // Mix the channels into the output buffer
+    if(myChannels == 1)
+    {
+      for(uInt32 i = 0; i < count; ++i)
+        buffer[i] = level[0][i] + level[1][i] + myVolumeClip;
+    }
+    else
+    {
+      for(uInt32 i = 0; i < count; ++i)
+      {
+        buffer[2 * i] = level[0][i] + myVolumeClip;
+        buffer[2 * i + 1] = level[1][i] + myVolumeClip;
+      }
+    }
+
+    buffer += count * myChannels;
+    samples -= count;
+  }
+}
@@ -68,6 +68,13 @@ class TIASound
     */
     void clipVolume(bool clip);
 
+    /**
+      Set whether samples are generated a batch at a time when the output
+      frequency matches the TIA frequency, which is the default.  Turning
+      it off is only useful to compare both ways of generating samples.
+    */
+    void batchProcessing(bool enable);
+
   public:
     /**
       Sets the specified sound register to the given value
@@ -127,12 +134,48 @@ class TIASound
           return false;
         }
 
+        // Answers the number of clocks up to and including the next pulse
+        uInt32 clocksUntilPulse() const
+        {
+          return (myCounter < myDivideByValue) ?
+              myDivideByValue - myCounter + 1 : 1;
+        }
+
+        // Advances by a number of clocks which doesn't reach the next pulse
+        void skip(uInt32 clocks)
+        {
+          myCounter += clocks;
+        }
+
       private:
         uInt32 myDivideByValue;
         uInt32 myCounter;
     };
 
   private:
+    /**
+      Clock the polynomial registers of the given channel once, as done
+      whenever its frequency divider outputs a pulse
+
+      @param c The channel to clock
+    */
+    void clockPolynomials(uInt32 c);
+
+    /**
+      Create sound samples when the output frequency matches the TIA
+      frequency.  Since a channel's output only changes when its
+      frequency divider pulses, the samples are filled a run at a time
+      and then mixed in batches.
+
+      @param buffer The location to store generated samples
+      @param samples The number of samples to generate
+    */
+    void processBatch(uInt8* buffer, uInt32 samples);
+
+  private:
+    // Number of samples mixed at a time by processBatch()
+    enum { BatchSize = 256 };
+
     uInt8 myAUDC[2];
     uInt8 myAUDF[2];
     uInt8 myAUDV[2];
@@ -147,6 +190,7 @@ class TIASound
     Int32  myOutputCounter;
     uInt32 myVolumePercentage;
     uInt8  myVolumeClip;
+    bool   myBatchProcessing;
 };
 
 #endif
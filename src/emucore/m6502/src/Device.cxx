@@ -16,7 +16,11 @@
 // $Id: Device.cxx,v 1.4 2007/01/01 18:04:50 stephena Exp $
 //============================================================================
 
+#include <cstring>
+
 #include "Device.hxx"
+#include "Serializer.hxx"
+#include "Deserializer.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Device::Device()
@@ -35,3 +39,29 @@ void Device::systemCyclesReset()
   // By default I do nothing when my system resets its cycle counter
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Device::snapshotSize()
+{
+  Serializer out;
+  save(out);
+
+  return out.get_str().size();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Device::saveSnapshot(uInt8* block)
+{
+  Serializer out;
+  save(out);
+
+  memcpy(block, out.get_str().data(), out.get_str().size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Device::loadSnapshot(const uInt8* block)
+{
+  // The system guarantees that the block holds snapshotSize() bytes, and
+  // load() reads back exactly what save() wrote
+  Deserializer in((const char*)block, 0xFFFFFFFF);
+  load(in);
+}
@@ -89,6 +89,32 @@ class Device
     */
     virtual bool load(Deserializer& in) = 0;
 
+    /**
+      Get the size of the block written by saveSnapshot().  It must not
+      change once the device has been installed.  By default this is the
+      size of the device's serialized state.
+
+      @return The size of the snapshot block in bytes
+    */
+    virtual uInt32 snapshotSize();
+
+    /**
+      Copies the current state of this device into a fixed-layout block of
+      snapshotSize() bytes.  Unlike save(), the block is a raw image of the
+      state which is only meaningful to the same build of the emulator.
+      By default the device's serialized state is stored in the block.
+
+      @param block The block to save to
+    */
+    virtual void saveSnapshot(uInt8* block);
+
+    /**
+      Restores the state of this device from a block written by saveSnapshot().
+
+      @param block The block to load from
+    */
+    virtual void loadSnapshot(const uInt8* block);
+
   public:
     /**
       Get the byte at the specified address
@@ -16,6 +16,9 @@
 // $Id: M6502.cxx,v 1.21 2007/01/01 18:04:50 stephena Exp $
 //============================================================================
 
+#include <cstring>
+#include <mutex>
+
 #include "M6502.hxx"
 
 #ifdef DEBUGGER_SUPPORT
@@ -36,16 +39,13 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle)
   myWriteTraps  = NULL;
 #endif
 
-  // Compute the BCD lookup table
-  uInt16 t;
-  for(t = 0; t < 256; ++t)
-  {
-    ourBCDTable[0][t] = ((t >> 4) * 10) + (t & 0x0f);
-    ourBCDTable[1][t] = (((t % 100) / 10) << 4) | (t % 10);
-  }
+  // The BCD lookup table is shared by every processor, so it is computed
+  // only once; this allows processors to be created from several threads
+  static std::once_flag bcdTableComputed;
+  std::call_once(bcdTableComputed, computeBCDTable);
 
   // Compute the System Cycle table
-  for(t = 0; t < 256; ++t)
+  for(uInt16 t = 0; t < 256; ++t)
   {
     myInstructionSystemCycleTable[t] = ourInstructionProcessorCycleTable[t] *
         mySystemCyclesPerProcessorCycle;
@@ -54,6 +54,16 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle)
   myTotalInstructionCount = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::computeBCDTable()
+{
+  for(uInt16 t = 0; t < 256; ++t)
+  {
+    ourBCDTable[0][t] = ((t >> 4) * 10) + (t & 0x0f);
+    ourBCDTable[1][t] = (((t % 100) / 10) << 4) | (t % 10);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::~M6502()
 {
@@ -63,6 +73,35 @@ M6502::~M6502()
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502::snapshotSize() const
+{
+  return sizeof(Snapshot);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::saveSnapshot(uInt8* block) const
+{
+  Snapshot s;
+  memset(&s, 0, sizeof(s));
+  s.A = A;  s.X = X;  s.Y = Y;  s.SP = SP;  s.IR = IR;  s.PC = PC;
+  s.N = N;  s.V = V;  s.B = B;  s.D = D;  s.I = I;  s.notZ = notZ;  s.C = C;
+  s.executionStatus = myExecutionStatus;
+
+  memcpy(block, &s, sizeof(s));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::loadSnapshot(const uInt8* block)
+{
+  Snapshot s;
+  memcpy(&s, block, sizeof(s));
+
+  A = s.A;  X = s.X;  Y = s.Y;  SP = s.SP;  IR = s.IR;  PC = s.PC;
+  N = s.N;  V = s.V;  B = s.B;  D = s.D;  I = s.I;  notZ = s.notZ;  C = s.C;
+  myExecutionStatus = s.executionStatus;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::install(System& system)
 {
@@ -121,6 +121,29 @@ class M6502
     */
     virtual bool load(Deserializer& in) = 0;
 
+    /**
+      Get the size of the block written by saveSnapshot().
+
+      @return The size of the snapshot block in bytes
+    */
+    virtual uInt32 snapshotSize() const;
+
+    /**
+      Copies the registers of the processor into a fixed-layout block of
+      snapshotSize() bytes.  See Device::saveSnapshot().
+
+      @param block The block to save to
+    */
+    virtual void saveSnapshot(uInt8* block) const;
+
+    /**
+      Restores the registers of the processor from a block written by
+      saveSnapshot().
+
+      @param block The block to load from
+    */
+    virtual void loadSnapshot(const uInt8* block);
+
     /**
       Get a null terminated string which is the processor's name (i.e. "M6532")
 
@@ -225,6 +248,11 @@ class M6502
     */
     void PS(uInt8 ps);
 
+    /**
+      Compute the BCD lookup table; this is done once per process.
+    */
+    static void computeBCDTable();
+
   protected:
     uInt8 A;    // Accumulator
     uInt8 X;    // X index register
@@ -291,6 +319,15 @@ class M6502
     /// Indicates if the last memory access was a read or not
     bool myLastAccessWasRead;
 
+    /// Layout of the registers in a snapshot block; the same fields as save()
+    struct Snapshot
+    {
+      uInt8 A, X, Y, SP, IR;
+      uInt16 PC;
+      bool N, V, B, D, I, notZ, C;
+      uInt8 executionStatus;
+    };
+
   protected:
     /// Addressing mode for each of the 256 opcodes
     static AddressingMode ourAddressingModeTable[256];
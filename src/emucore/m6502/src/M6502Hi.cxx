@@ -16,6 +16,8 @@
 // $Id: M6502Hi.cxx,v 1.19 2007/01/01 18:04:51 stephena Exp $
 //============================================================================
 
+#include <cstring>
+
 #include "M6502Hi.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
@@ -29,6 +31,11 @@ using namespace std;
 
 #define debugStream ale::Logger::Info
 
+// Threaded dispatch relies on the labels-as-values extension, and does not support the debugger
+#if defined(__GNUC__) && !defined(DEBUGGER_SUPPORT) && !defined(DEBUG)
+  #define M6502_THREADED_DISPATCH
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502High::M6502High(uInt32 systemCyclesPerProcessorCycle)
     : M6502(systemCyclesPerProcessorCycle)
@@ -47,7 +54,7 @@ M6502High::~M6502High()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline uInt8 M6502High::peek(uInt16 address)
+BSPF_ALWAYS_INLINE uInt8 M6502High::peek(uInt16 address)
 {
   if(address != myLastAddress)
   {
@@ -72,7 +79,7 @@ inline uInt8 M6502High::peek(uInt16 address)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void M6502High::poke(uInt16 address, uInt8 value)
+BSPF_ALWAYS_INLINE void M6502High::poke(uInt16 address, uInt8 value)
 {
   if(address != myLastAddress)
   {
@@ -280,6 +287,35 @@ bool M6502High::save(Serializer& out)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502High::snapshotSize() const
+{
+  return M6502::snapshotSize() + sizeof(myNumberOfDistinctAccesses) +
+         sizeof(myLastAddress);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502High::saveSnapshot(uInt8* block) const
+{
+  M6502::saveSnapshot(block);
+  block += M6502::snapshotSize();
+
+  memcpy(block, &myNumberOfDistinctAccesses, sizeof(myNumberOfDistinctAccesses));
+  block += sizeof(myNumberOfDistinctAccesses);
+  memcpy(block, &myLastAddress, sizeof(myLastAddress));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502High::loadSnapshot(const uInt8* block)
+{
+  M6502::loadSnapshot(block);
+  block += M6502::snapshotSize();
+
+  memcpy(&myNumberOfDistinctAccesses, block, sizeof(myNumberOfDistinctAccesses));
+  block += sizeof(myNumberOfDistinctAccesses);
+  memcpy(&myLastAddress, block, sizeof(myLastAddress));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502High::load(Deserializer& in)
 {
@@ -331,3 +367,163 @@ const char* M6502High::name() const
 {
   return "M6502High";
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502HighThreaded::M6502HighThreaded(uInt32 systemCyclesPerProcessorCycle)
+    : M6502High(systemCyclesPerProcessorCycle)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502HighThreaded::~M6502HighThreaded()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502HighThreaded::execute(uInt32 number)
+{
+#if defined(M6502_THREADED_DISPATCH)
+  // Address of the handler of each opcode; opcodes which halt the 6502 are illegal
+  #define M6502_OPCODE(op) opcode_##op
+  static const void* const ourDispatchTable[256] = {
+    &&M6502_OPCODE(00), &&M6502_OPCODE(01), &&illegal, &&M6502_OPCODE(03),
+    &&M6502_OPCODE(04), &&M6502_OPCODE(05), &&M6502_OPCODE(06), &&M6502_OPCODE(07),
+    &&M6502_OPCODE(08), &&M6502_OPCODE(09), &&M6502_OPCODE(0a), &&M6502_OPCODE(0b),
+    &&M6502_OPCODE(0c), &&M6502_OPCODE(0d), &&M6502_OPCODE(0e), &&M6502_OPCODE(0f),
+    &&M6502_OPCODE(10), &&M6502_OPCODE(11), &&illegal, &&M6502_OPCODE(13),
+    &&M6502_OPCODE(14), &&M6502_OPCODE(15), &&M6502_OPCODE(16), &&M6502_OPCODE(17),
+    &&M6502_OPCODE(18), &&M6502_OPCODE(19), &&M6502_OPCODE(1a), &&M6502_OPCODE(1b),
+    &&M6502_OPCODE(1c), &&M6502_OPCODE(1d), &&M6502_OPCODE(1e), &&M6502_OPCODE(1f),
+    &&M6502_OPCODE(20), &&M6502_OPCODE(21), &&illegal, &&M6502_OPCODE(23),
+    &&M6502_OPCODE(24), &&M6502_OPCODE(25), &&M6502_OPCODE(26), &&M6502_OPCODE(27),
+    &&M6502_OPCODE(28), &&M6502_OPCODE(29), &&M6502_OPCODE(2a), &&M6502_OPCODE(2b),
+    &&M6502_OPCODE(2c), &&M6502_OPCODE(2d), &&M6502_OPCODE(2e), &&M6502_OPCODE(2f),
+    &&M6502_OPCODE(30), &&M6502_OPCODE(31), &&illegal, &&M6502_OPCODE(33),
+    &&M6502_OPCODE(34), &&M6502_OPCODE(35), &&M6502_OPCODE(36), &&M6502_OPCODE(37),
+    &&M6502_OPCODE(38), &&M6502_OPCODE(39), &&M6502_OPCODE(3a), &&M6502_OPCODE(3b),
+    &&M6502_OPCODE(3c), &&M6502_OPCODE(3d), &&M6502_OPCODE(3e), &&M6502_OPCODE(3f),
+    &&M6502_OPCODE(40), &&M6502_OPCODE(41), &&illegal, &&M6502_OPCODE(43),
+    &&M6502_OPCODE(44), &&M6502_OPCODE(45), &&M6502_OPCODE(46), &&M6502_OPCODE(47),
+    &&M6502_OPCODE(48), &&M6502_OPCODE(49), &&M6502_OPCODE(4a), &&M6502_OPCODE(4b),
+    &&M6502_OPCODE(4c), &&M6502_OPCODE(4d), &&M6502_OPCODE(4e), &&M6502_OPCODE(4f),
+    &&M6502_OPCODE(50), &&M6502_OPCODE(51), &&illegal, &&M6502_OPCODE(53),
+    &&M6502_OPCODE(54), &&M6502_OPCODE(55), &&M6502_OPCODE(56), &&M6502_OPCODE(57),
+    &&M6502_OPCODE(58), &&M6502_OPCODE(59), &&M6502_OPCODE(5a), &&M6502_OPCODE(5b),
+    &&M6502_OPCODE(5c), &&M6502_OPCODE(5d), &&M6502_OPCODE(5e), &&M6502_OPCODE(5f),
+    &&M6502_OPCODE(60), &&M6502_OPCODE(61), &&illegal, &&M6502_OPCODE(63),
+    &&M6502_OPCODE(64), &&M6502_OPCODE(65), &&M6502_OPCODE(66), &&M6502_OPCODE(67),
+    &&M6502_OPCODE(68), &&M6502_OPCODE(69), &&M6502_OPCODE(6a), &&M6502_OPCODE(6b),
+    &&M6502_OPCODE(6c), &&M6502_OPCODE(6d), &&M6502_OPCODE(6e), &&M6502_OPCODE(6f),
+    &&M6502_OPCODE(70), &&M6502_OPCODE(71), &&illegal, &&M6502_OPCODE(73),
+    &&M6502_OPCODE(74), &&M6502_OPCODE(75), &&M6502_OPCODE(76), &&M6502_OPCODE(77),
+    &&M6502_OPCODE(78), &&M6502_OPCODE(79), &&M6502_OPCODE(7a), &&M6502_OPCODE(7b),
+    &&M6502_OPCODE(7c), &&M6502_OPCODE(7d), &&M6502_OPCODE(7e), &&M6502_OPCODE(7f),
+    &&M6502_OPCODE(80), &&M6502_OPCODE(81), &&M6502_OPCODE(82), &&M6502_OPCODE(83),
+    &&M6502_OPCODE(84), &&M6502_OPCODE(85), &&M6502_OPCODE(86), &&M6502_OPCODE(87),
+    &&M6502_OPCODE(88), &&M6502_OPCODE(89), &&M6502_OPCODE(8a), &&M6502_OPCODE(8b),
+    &&M6502_OPCODE(8c), &&M6502_OPCODE(8d), &&M6502_OPCODE(8e), &&M6502_OPCODE(8f),
+    &&M6502_OPCODE(90), &&M6502_OPCODE(91), &&illegal, &&M6502_OPCODE(93),
+    &&M6502_OPCODE(94), &&M6502_OPCODE(95), &&M6502_OPCODE(96), &&M6502_OPCODE(97),
+    &&M6502_OPCODE(98), &&M6502_OPCODE(99), &&M6502_OPCODE(9a), &&M6502_OPCODE(9b),
+    &&M6502_OPCODE(9c), &&M6502_OPCODE(9d), &&M6502_OPCODE(9e), &&M6502_OPCODE(9f),
+    &&M6502_OPCODE(a0), &&M6502_OPCODE(a1), &&M6502_OPCODE(a2), &&M6502_OPCODE(a3),
+    &&M6502_OPCODE(a4), &&M6502_OPCODE(a5), &&M6502_OPCODE(a6), &&M6502_OPCODE(a7),
+    &&M6502_OPCODE(a8), &&M6502_OPCODE(a9), &&M6502_OPCODE(aa), &&M6502_OPCODE(ab),
+    &&M6502_OPCODE(ac), &&M6502_OPCODE(ad), &&M6502_OPCODE(ae), &&M6502_OPCODE(af),
+    &&M6502_OPCODE(b0), &&M6502_OPCODE(b1), &&illegal, &&M6502_OPCODE(b3),
+    &&M6502_OPCODE(b4), &&M6502_OPCODE(b5), &&M6502_OPCODE(b6), &&M6502_OPCODE(b7),
+    &&M6502_OPCODE(b8), &&M6502_OPCODE(b9), &&M6502_OPCODE(ba), &&M6502_OPCODE(bb),
+    &&M6502_OPCODE(bc), &&M6502_OPCODE(bd), &&M6502_OPCODE(be), &&M6502_OPCODE(bf),
+    &&M6502_OPCODE(c0), &&M6502_OPCODE(c1), &&M6502_OPCODE(c2), &&M6502_OPCODE(c3),
+    &&M6502_OPCODE(c4), &&M6502_OPCODE(c5), &&M6502_OPCODE(c6), &&M6502_OPCODE(c7),
+    &&M6502_OPCODE(c8), &&M6502_OPCODE(c9), &&M6502_OPCODE(ca), &&M6502_OPCODE(cb),
+    &&M6502_OPCODE(cc), &&M6502_OPCODE(cd), &&M6502_OPCODE(ce), &&M6502_OPCODE(cf),
+    &&M6502_OPCODE(d0), &&M6502_OPCODE(d1), &&illegal, &&M6502_OPCODE(d3),
+    &&M6502_OPCODE(d4), &&M6502_OPCODE(d5), &&M6502_OPCODE(d6), &&M6502_OPCODE(d7),
+    &&M6502_OPCODE(d8), &&M6502_OPCODE(d9), &&M6502_OPCODE(da), &&M6502_OPCODE(db),
+    &&M6502_OPCODE(dc), &&M6502_OPCODE(dd), &&M6502_OPCODE(de), &&M6502_OPCODE(df),
+    &&M6502_OPCODE(e0), &&M6502_OPCODE(e1), &&M6502_OPCODE(e2), &&M6502_OPCODE(e3),
+    &&M6502_OPCODE(e4), &&M6502_OPCODE(e5), &&M6502_OPCODE(e6), &&M6502_OPCODE(e7),
+    &&M6502_OPCODE(e8), &&M6502_OPCODE(e9), &&M6502_OPCODE(ea), &&M6502_OPCODE(eb),
+    &&M6502_OPCODE(ec), &&M6502_OPCODE(ed), &&M6502_OPCODE(ee), &&M6502_OPCODE(ef),
+    &&M6502_OPCODE(f0), &&M6502_OPCODE(f1), &&illegal, &&M6502_OPCODE(f3),
+    &&M6502_OPCODE(f4), &&M6502_OPCODE(f5), &&M6502_OPCODE(f6), &&M6502_OPCODE(f7),
+    &&M6502_OPCODE(f8), &&M6502_OPCODE(f9), &&M6502_OPCODE(fa), &&M6502_OPCODE(fb),
+    &&M6502_OPCODE(fc), &&M6502_OPCODE(fd), &&M6502_OPCODE(fe), &&M6502_OPCODE(ff)
+  };
+
+  // Clear all of the execution status bits except for the fatal error bit
+  myExecutionStatus &= FatalErrorBit;
+
+  // Loop until execution is stopped or a fatal error occurs
+  for(;;)
+  {
+    if(!myExecutionStatus && (number != 0))
+    {
+      uInt16 operandAddress = 0;
+      uInt8 operand = 0;
+
+      // Each handler ends by fetching the next instruction and jumping straight to its handler,
+      // with the same checks as the loop of M6502High::execute(), which counts every instruction
+      // before looking at the status bits
+      #define M6502_NEXT \
+        myTotalInstructionCount++; \
+        if((--number == 0) || myExecutionStatus) \
+          goto done; \
+        operandAddress = 0; \
+        operand = 0; \
+        IR = peek(PC++); \
+        goto *ourDispatchTable[IR]
+
+      // Fetch the first instruction
+      IR = peek(PC++);
+      goto *ourDispatchTable[IR];
+
+      // 6502 instruction emulation is generated by an M4 macro file
+      #include "M6502HiThreaded.ins"
+
+    illegal:
+      // Oops, illegal instruction executed so set fatal error flag
+      myExecutionStatus |= FatalErrorBit;
+      myTotalInstructionCount++;
+      --number;
+
+    done:
+      #undef M6502_NEXT
+      #undef M6502_OPCODE
+      ;
+    }
+
+    // See if we need to handle an interrupt
+    if((myExecutionStatus & MaskableInterruptBit) || 
+        (myExecutionStatus & NonmaskableInterruptBit))
+    {
+      // Yes, so handle the interrupt
+      interruptHandler();
+    }
+
+    // See if execution has been stopped
+    if(myExecutionStatus & StopExecutionBit)
+    {
+      // Yes, so answer that everything finished fine
+      return true;
+    }
+
+    // See if a fatal error has occured
+    if(myExecutionStatus & FatalErrorBit)
+    {
+      // Yes, so answer that something when wrong
+      return false;
+    }
+
+    // See if we've executed the specified number of instructions
+    if(number == 0)
+    {
+      // Yes, so answer that everything finished fine
+      return true;
+    }
+  }
+#else
+  return M6502High::execute(number);
+#endif
+}
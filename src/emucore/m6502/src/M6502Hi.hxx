@@ -80,6 +80,14 @@ class M6502High : public M6502
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Snapshot the registers along with the distinct access tracking.
+      See M6502::saveSnapshot().
+    */
+    virtual uInt32 snapshotSize() const;
+    virtual void saveSnapshot(uInt8* block) const;
+    virtual void loadSnapshot(const uInt8* block);
+
     /**
       Get a null terminated string which is the processors's name (i.e. "M6532")
 
@@ -111,7 +119,7 @@ class M6502High : public M6502
 
       @return The byte at the specified address
     */
-    inline uInt8 peek(uInt16 address);
+    BSPF_ALWAYS_INLINE uInt8 peek(uInt16 address);
 
     /**
       Change the byte at the specified address to the given value and
@@ -120,7 +128,7 @@ class M6502High : public M6502
       @param address The address where the value should be stored
       @param value The value to be stored at the address
     */
-    inline void poke(uInt16 address, uInt8 value);
+    BSPF_ALWAYS_INLINE void poke(uInt16 address, uInt8 value);
 
   private:
     // Indicates the numer of distinct memory accesses
@@ -129,5 +137,35 @@ class M6502High : public M6502
     // Indicates the last address which was accessed
     uInt16 myLastAddress;
 };
+
+/**
+  The same 6502 emulator as M6502High, which instead of decoding each
+  instruction through a switch jumps from the end of one instruction's
+  code straight to the code of the next one (direct-threaded dispatch).
+  It is selected by setting "cpu" to "threaded", and falls back to
+  M6502High::execute() on compilers without computed gotos.
+*/
+class M6502HighThreaded : public M6502High
+{
+  public:
+    /**
+      Create a new threaded high compatibility 6502 microprocessor with the
+      specified cycle multiplier.
+
+      @param systemCyclesPerProcessorCycle The cycle multiplier
+    */
+    M6502HighThreaded(uInt32 systemCyclesPerProcessorCycle);
+
+    /**
+      Destructor
+    */
+    virtual ~M6502HighThreaded();
+
+  public:
+    /**
+      See M6502High::execute().
+    */
+    virtual bool execute(uInt32 number);
+};
 #endif
 
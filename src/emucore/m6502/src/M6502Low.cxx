@@ -17,6 +17,7 @@
 //============================================================================
 
 #include "M6502Low.hxx"
+#include "M6532.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
 
@@ -42,7 +43,7 @@ M6502Low::~M6502Low()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline uInt8 M6502Low::peek(uInt16 address)
+BSPF_ALWAYS_INLINE uInt8 M6502Low::peek(uInt16 address)
 {
 #ifdef DEBUGGER_SUPPORT
   if(myReadTraps != NULL && myReadTraps->isSet(address))
@@ -59,7 +60,7 @@ inline uInt8 M6502Low::peek(uInt16 address)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void M6502Low::poke(uInt16 address, uInt8 value)
+BSPF_ALWAYS_INLINE void M6502Low::poke(uInt16 address, uInt8 value)
 {
 #ifdef DEBUGGER_SUPPORT
   if(myWriteTraps != NULL && myWriteTraps->isSet(address))
@@ -188,6 +189,64 @@ bool M6502Low::execute(uInt32 number)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502Low::skipTimerPolling(uInt32 number)
+{
+#ifdef DEBUGGER_SUPPORT
+  // Breakpoints and traps need every instruction to be executed
+  return 0;
+#else
+  // The loop must be a load from the timer followed by this branch, and
+  // its code must be readable without the side effects of fetching it
+  uInt8 code[5];
+  for(uInt16 i = 0; i < 5; ++i)
+  {
+    if(!mySystem->peekDirect(PC + i, code[i]))
+      return 0;
+  }
+
+  if((code[0] != 0xAD && code[0] != 0xAE && code[0] != 0xAC) ||
+     code[3] != 0xD0 || code[4] != 0xFB)
+    return 0;
+
+  M6532* timer = mySystem->timerAt(code[1] | ((uInt16)code[2] << 8));
+  if(timer == 0)
+    return 0;
+
+  // System cycles taken by one iteration, and the system cycle count at
+  // which the next iteration's load reads the timer
+  Int32 loadCycles = myInstructionSystemCycleTable[code[0]];
+  Int32 loopCycles = loadCycles + myInstructionSystemCycleTable[0xD0] +
+      ((((PC + 5) ^ PC) & 0xFF00) ? mySystemCyclesPerProcessorCycle << 1 :
+      mySystemCyclesPerProcessorCycle);
+  Int32 read = (Int32)mySystem->cycles() + loadCycles;
+
+  Int32 last = timer->lastNonZeroTimerRead();
+  if(read > last)
+    return 0;
+
+  // Leave at least one instruction for execute() to count this branch
+  uInt32 iterations = (uInt32)((last - read) / loopCycles) + 1;
+  iterations = BSPF_min(iterations, (number - 1) >> 1);
+  if(iterations == 0)
+    return 0;
+
+  // The registers and flags are left as the last skipped load sets them
+  uInt8 value = timer->timerValueAt(read + (Int32)(iterations - 1) * loopCycles);
+  if(code[0] == 0xAD)
+    A = value;
+  else if(code[0] == 0xAE)
+    X = value;
+  else
+    Y = value;
+  notZ = value;
+  N = value & 0x80;
+
+  mySystem->incrementCycles(iterations * loopCycles);
+  return iterations << 1;
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502Low::interruptHandler()
 {
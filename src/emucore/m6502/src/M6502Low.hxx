@@ -105,7 +105,7 @@ class M6502Low : public M6502
 
       @return The byte at the specified address
     */
-    inline uInt8 peek(uInt16 address);
+    BSPF_ALWAYS_INLINE uInt8 peek(uInt16 address);
 
     /**
       Change the byte at the specified address to the given value
@@ -113,7 +113,20 @@ class M6502Low : public M6502
       @param address The address where the value should be stored
       @param value The value to be stored at the address
     */
-    inline void poke(uInt16 address, uInt8 value);
+    BSPF_ALWAYS_INLINE void poke(uInt16 address, uInt8 value);
+
+  private:
+    /**
+      Called when a BNE branched back over a single absolute load.  If
+      that load reads the M6532 timer, the loop is only waiting for the
+      timer to reach zero, so the iterations that read a non-zero value
+      are skipped by advancing the system cycles.
+
+      @param number The number of instructions execute() may still run,
+                    including the branch
+      @return The number of instructions that were skipped
+    */
+    uInt32 skipTimerPolling(uInt32 number);
 };
 #endif
 
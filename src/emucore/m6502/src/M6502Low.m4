@@ -250,6 +250,10 @@ define(M6502_BNE, `{
     mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
     PC = address;
+
+    // Branching back over one absolute load may be polling the timer
+    if(operand == 0xFB)
+      number -= skipTimerPolling(number);
   }
 }')
 
@@ -17,11 +17,14 @@
 //============================================================================
 
 #include <assert.h>
+#include <cstring>
 #include <iostream>
 
 #include "Device.hxx"
 #include "M6502.hxx"
 #include "TIA.hxx"
+#include "M6532.hxx"
+#include "Cart.hxx"
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
@@ -34,8 +37,12 @@ System::System(uInt16 n, uInt16 m)
     myPageMask((1 << m) - 1),
     myNumberOfPages(1 << (n - m)),
     myNumberOfDevices(0),
+    mySnapshotSize(0),
+    mySnapshotLayout(0),
     myM6502(0),
     myTIA(0),
+    myM6532(0),
+    myCartridge(0),
     myCycles(0),
     myDataBusState(0)
 {
@@ -101,6 +108,7 @@ void System::attach(Device* device)
 
   // Add device to my collection of devices
   myDevices[myNumberOfDevices++] = device;
+  mySnapshotSize = 0;
 
   // Ask the device to install itself
   device->install(*this);
@@ -111,6 +119,7 @@ void System::attach(M6502* m6502)
 {
   // Remember the processor
   myM6502 = m6502;
+  mySnapshotSize = 0;
 
   // Ask the processor to install itself
   myM6502->install(*this);
@@ -123,6 +132,20 @@ void System::attach(TIA* tia)
   attach((Device*) tia);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::attach(M6532* m6532)
+{
+  myM6532 = m6532;
+  attach((Device*) m6532);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::attach(Cartridge* cartridge)
+{
+  myCartridge = cartridge;
+  attach((Device*) cartridge);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool System::save(Serializer& out)
 {
@@ -284,6 +307,82 @@ bool System::loadState(const string& md5sum, Deserializer& in)
   return true;  // success
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Folds a string, then a size, into an FNV-1a hash
+static uInt32 hashLayout(uInt32 hash, const char* name, uInt32 size)
+{
+  for(; *name != 0; ++name)
+    hash = (hash ^ (uInt8)*name) * 16777619u;
+  for(int i = 0; i < 4; ++i)
+    hash = (hash ^ ((size >> (i << 3)) & 0xff)) * 16777619u;
+
+  return hash;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 System::snapshotSize()
+{
+  if(mySnapshotSize == 0)
+  {
+    mySnapshotSize = sizeof(myCycles) + myM6502->snapshotSize();
+    mySnapshotLayout = hashLayout(2166136261u, myM6502->name(), myM6502->snapshotSize());
+
+    for(uInt32 i = 0; i < myNumberOfDevices; ++i)
+    {
+      myDeviceSnapshotSizes[i] = myDevices[i]->snapshotSize();
+      mySnapshotSize += myDeviceSnapshotSizes[i];
+      mySnapshotLayout = hashLayout(mySnapshotLayout, myDevices[i]->name(),
+                                    myDeviceSnapshotSizes[i]);
+    }
+  }
+
+  return mySnapshotSize;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 System::snapshotLayout()
+{
+  snapshotSize();
+  return mySnapshotLayout;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::saveSnapshot(uInt8* block)
+{
+  // Make sure the device block sizes are known
+  snapshotSize();
+
+  memcpy(block, &myCycles, sizeof(myCycles));
+  block += sizeof(myCycles);
+
+  myM6502->saveSnapshot(block);
+  block += myM6502->snapshotSize();
+
+  for(uInt32 i = 0; i < myNumberOfDevices; ++i)
+  {
+    myDevices[i]->saveSnapshot(block);
+    block += myDeviceSnapshotSizes[i];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::loadSnapshot(const uInt8* block)
+{
+  snapshotSize();
+
+  memcpy(&myCycles, block, sizeof(myCycles));
+  block += sizeof(myCycles);
+
+  myM6502->loadSnapshot(block);
+  block += myM6502->snapshotSize();
+
+  for(uInt32 i = 0; i < myNumberOfDevices; ++i)
+  {
+    myDevices[i]->loadSnapshot(block);
+    block += myDeviceSnapshotSizes[i];
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 System::System(const System& s)
   : myAddressMask(s.myAddressMask),
@@ -303,21 +402,18 @@ System& System::operator = (const System&)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 System::peek(uInt16 addr) 
+uInt8 System::peekDevice(Device* device, uInt16 addr)
 {
-  PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
-
   uInt8 result;
- 
-  // See if this page uses direct accessing or not 
-  if(access.directPeekBase != 0)
-  {
-    result = *(access.directPeekBase + (addr & myPageMask));
-  }
+
+  if(device == myTIA)
+    result = myTIA->TIA::peek(addr);
+  else if(device == myM6532)
+    result = myM6532->M6532::peek(addr);
+  else if(device == myCartridge)
+    result = myCartridge->peekCartridge(addr);
   else
-  {
-    result = access.device->peek(addr);
-  }
+    result = device->peek(addr);
 
 #ifdef DEBUGGER_SUPPORT
   if(!myDataBusLocked)
@@ -328,19 +424,16 @@ uInt8 System::peek(uInt16 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void System::poke(uInt16 addr, uInt8 value)
+void System::pokeDevice(Device* device, uInt16 addr, uInt8 value)
 {
-  PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
-  
-  // See if this page uses direct accessing or not 
-  if(access.directPokeBase != 0)
-  {
-    *(access.directPokeBase + (addr & myPageMask)) = value;
-  }
+  if(device == myTIA)
+    myTIA->TIA::poke(addr, value);
+  else if(device == myM6532)
+    myM6532->M6532::poke(addr, value);
+  else if(device == myCartridge)
+    myCartridge->pokeCartridge(addr, value);
   else
-  {
-    access.device->poke(addr, value);
-  }
+    device->poke(addr, value);
 
 #ifdef DEBUGGER_SUPPORT
   if(!myDataBusLocked)
@@ -348,6 +441,31 @@ void System::poke(uInt16 addr, uInt8 value)
     myDataBusState = value;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool System::peekDirect(uInt16 addr, uInt8& value) const
+{
+  const PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
+
+  if(access.directPeekBase == 0)
+    return false;
+
+  value = *(access.directPeekBase + (addr & myPageMask));
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6532* System::timerAt(uInt16 addr) const
+{
+  const PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
+
+  // The timer is read at offsets 4 and 6 of the M6532's I/O pages
+  if(myM6532 == 0 || access.device != myM6532 || access.directPeekBase != 0 ||
+     (addr & 0x05) != 0x04)
+    return 0;
+
+  return myM6532;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::lockDataBus()
 {
@@ -22,6 +22,8 @@
 class Device;
 class M6502;
 class TIA;
+class M6532;
+class Cartridge;
 class NullDevice;
 class Serializer;
 class Deserializer;
@@ -114,6 +116,22 @@ class System
     */
     void attach(TIA* tia);
 
+    /**
+      Attach the specified M6532 device and claim ownership of it.  The
+      device will be asked to install itself.
+
+      @param m6532 The M6532 device to attach to the system
+    */
+    void attach(M6532* m6532);
+
+    /**
+      Attach the specified cartridge and claim ownership of it.  The
+      cartridge will be asked to install itself.
+
+      @param cartridge The cartridge to attach to the system
+    */
+    void attach(Cartridge* cartridge);
+
     /**
       Saves the current state of Stella to the given file.  Calls
       save on every device and CPU attached to this system.
@@ -136,6 +154,39 @@ class System
     */
     bool loadState(const std::string& md5sum, Deserializer& in);
 
+    /**
+      Get the size of the block written by saveSnapshot().
+
+      @return  The size of the snapshot block in bytes
+    */
+    uInt32 snapshotSize();
+
+    /**
+      Get an identifier of the layout of the block written by saveSnapshot(),
+      derived from the names and snapshot sizes of the CPU and each device.
+      Blocks can only be loaded by a system with the same layout.
+
+      @return  The layout identifier
+    */
+    uInt32 snapshotLayout();
+
+    /**
+      Copies the current state of Stella into a fixed-layout block of
+      snapshotSize() bytes: the cycle count, then the CPU and each device.
+      This is much cheaper than saveState(), but the block is a raw image
+      which can only be loaded by the same build, for the same cartridge.
+
+      @param block  The block to save to
+    */
+    void saveSnapshot(uInt8* block);
+
+    /**
+      Restores the state of Stella from a block written by saveSnapshot().
+
+      @param block  The block to load from
+    */
+    void loadSnapshot(const uInt8* block);
+
   public:
     /**
       Answer the 6502 microprocessor attached to the system.  If a
@@ -246,7 +297,7 @@ class System
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address);
+    BSPF_ALWAYS_INLINE uInt8 peek(uInt16 address);
 
     /**
       Change the byte at the specified address to the given value.
@@ -256,7 +307,27 @@ class System
       @param address The address where the value should be stored
       @param value The value to be stored at the address
     */
-    void poke(uInt16 address, uInt8 value);
+    BSPF_ALWAYS_INLINE void poke(uInt16 address, uInt8 value);
+
+    /**
+      Get the byte at the specified address if that has no side effects,
+      which is the case for pages that are accessed directly.  The data
+      bus state isn't changed.
+
+      @param address The address to read
+      @param value Set to the byte at the address
+      @return True if the byte could be read
+    */
+    bool peekDirect(uInt16 address, uInt8& value) const;
+
+    /**
+      Answer the attached M6532 if peek() of the specified address reads
+      its timer (INTIM), otherwise the null pointer.
+
+      @param address The address to check
+      @return The M6532 or the null pointer
+    */
+    M6532* timerAt(uInt16 address) const;
 
     /**
       Lock/unlock the data bus. When the bus is locked, peek() and
@@ -315,6 +386,17 @@ class System
     */
     const PageAccess& getPageAccess(uInt16 page);
  
+  private:
+    /**
+      The part of peek() and poke() for pages which are not directly
+      accessed.  Kept out of line so that the direct case stays small
+      enough to be inlined into the processor cores.  The TIA and the
+      M6532 are called without virtual dispatch, and the cartridge through
+      the accessors of its class, which Cartridge::create() selects.
+    */
+    uInt8 peekDevice(Device* device, uInt16 address);
+    void pokeDevice(Device* device, uInt16 address, uInt8 value);
+
   private:
     // Mask to apply to an address before accessing memory
     const uInt16 myAddressMask;
@@ -337,12 +419,24 @@ class System
     // Number of devices attached to the system
     uInt32 myNumberOfDevices;
 
+    // Size of each device's snapshot block, and of the whole snapshot;
+    // computed on first use (mySnapshotSize is 0 until then)
+    uInt32 myDeviceSnapshotSizes[100];
+    uInt32 mySnapshotSize;
+    uInt32 mySnapshotLayout;
+
     // 6502 processor attached to the system or the null pointer
     M6502* myM6502;
 
     // TIA device attached to the system or the null pointer
     TIA* myTIA;
 
+    // M6532 device attached to the system or the null pointer
+    M6532* myM6532;
+
+    // Cartridge attached to the system or the null pointer
+    Cartridge* myCartridge;
+
     // Number of system cycles executed since the last reset
     uInt32 myCycles;
 
@@ -371,4 +465,43 @@ inline uInt8 System::getDataBusState() const
   return myDataBusState;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BSPF_ALWAYS_INLINE uInt8 System::peek(uInt16 addr)
+{
+  const PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
+
+  // See if this page uses direct accessing or not
+  if(access.directPeekBase == 0)
+    return peekDevice(access.device, addr);
+
+  uInt8 result = *(access.directPeekBase + (addr & myPageMask));
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = result;
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BSPF_ALWAYS_INLINE void System::poke(uInt16 addr, uInt8 value)
+{
+  const PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
+
+  // See if this page uses direct accessing or not
+  if(access.directPokeBase == 0)
+  {
+    pokeDevice(access.device, addr, value);
+    return;
+  }
+
+  *(access.directPokeBase + (addr & myPageMask)) = value;
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = value;
+}
+
 #endif
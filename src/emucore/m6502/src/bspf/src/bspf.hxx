@@ -81,6 +81,16 @@ typedef unsigned int uInt32;
   #define BSPF_vsnprintf vsnprintf
 #endif
 
+// Inline even where the compiler's size heuristics would not, such as
+// the memory accesses inside the processor cores' execute loops
+#if defined(__GNUC__)
+  #define BSPF_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+  #define BSPF_ALWAYS_INLINE __forceinline
+#else
+  #define BSPF_ALWAYS_INLINE inline
+#endif
+
 // Some convenience functions
 template<typename T> inline void BSPF_swap(T &a, T &b) { T tmp = a; a = b; b = tmp; }
 template<typename T> inline T BSPF_abs (T x) { return (x>=0) ? x : -x; }
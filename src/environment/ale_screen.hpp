@@ -25,6 +25,15 @@
 
 typedef unsigned char pixel_t;
 
+/** Formats in which the screen can be written into a caller-owned buffer. */
+enum ScreenFormat {
+  SCREEN_PALETTE    = 0, // One palette index per pixel
+  SCREEN_RGB        = 1, // Three bytes (R, G, B) per pixel
+  SCREEN_GRAYSCALE  = 2, // One grayscale byte per pixel
+  SCREEN_PREPROCESSED = 3 // The grayscale, max-pooled and resized observation configured by
+                          //  the preprocess_* settings
+};
+
 /** A simple wrapper around an Atari screen. */ 
 class ALEScreen { 
   public:
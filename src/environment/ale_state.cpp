@@ -17,9 +17,64 @@
 #include "../common/Constants.h"
 #include "../games/RomSettings.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
+// Granularity at which a delta state compares snapshots
+static const size_t DELTA_CHUNK_SIZE = 8;
+
+// Longest chain of deltas; past it states are stored in full, which bounds the cost of restoring
+static const int MAX_DELTA_DEPTH = 32;
+
+// Multipliers of the state hash, odd 64-bit constants with well mixed bits
+static const uint64_t HASH_PRIME_1 = 0x9e3779b185ebca87ULL;
+static const uint64_t HASH_PRIME_2 = 0xc2b2ae3d27d4eb4fULL;
+
+static inline uint64_t readWord(const unsigned char* data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+static inline uint64_t mixWord(uint64_t acc, uint64_t word) {
+  acc += word * HASH_PRIME_2;
+  acc = (acc << 31) | (acc >> 33);
+  return acc * HASH_PRIME_1;
+}
+
+/** Hashes a block of bytes into 64 bits. The bulk of the block is read as four interleaved
+  *  streams of 8-byte words, which keeps several multiplications in flight at once. */
+static uint64_t hashBytes(const unsigned char* data, size_t size) {
+  uint64_t lanes[4] = { HASH_PRIME_1 + HASH_PRIME_2, HASH_PRIME_2, 0, -HASH_PRIME_1 };
+
+  size_t offset = 0;
+  for (; offset + 32 <= size; offset += 32) {
+    lanes[0] = mixWord(lanes[0], readWord(data + offset));
+    lanes[1] = mixWord(lanes[1], readWord(data + offset + 8));
+    lanes[2] = mixWord(lanes[2], readWord(data + offset + 16));
+    lanes[3] = mixWord(lanes[3], readWord(data + offset + 24));
+  }
+
+  uint64_t h = size;
+  for (int i = 0; i < 4; i++)
+    h = mixWord(h, lanes[i]);
+  for (; offset + 8 <= size; offset += 8)
+    h = mixWord(h, readWord(data + offset));
+  for (; offset < size; offset++)
+    h = mixWord(h, data[offset]);
+
+  // Final avalanche, so that every input bit affects every output bit
+  h ^= h >> 33;
+  h *= HASH_PRIME_2;
+  h ^= h >> 29;
+  h *= HASH_PRIME_1;
+  h ^= h >> 32;
+  return h;
+}
+
 /** Default constructor - loads settings from system */ 
 ALEState::ALEState():
   m_left_paddle(PADDLE_DEFAULT_VALUE),
@@ -35,9 +90,12 @@ ALEState::ALEState(const ALEState &rhs, const std::string &serialized):
   m_right_paddle(rhs.m_right_paddle),
   m_frame_number(rhs.m_frame_number),
   m_episode_frame_number(rhs.m_episode_frame_number),
-  m_serialized_state(serialized),
   m_mode(rhs.m_mode),
   m_difficulty(rhs.m_difficulty) {
+  std::shared_ptr<SavedData> saved = std::make_shared<SavedData>();
+  saved->serialized = serialized;
+  saved->depth = 0;
+  m_saved = saved;
 }
 
 ALEState::ALEState(const std::string &serialized) {
@@ -48,28 +106,23 @@ ALEState::ALEState(const std::string &serialized) {
   this->m_episode_frame_number = des.getInt();
   this->m_mode = des.getInt();
   this->m_difficulty = des.getInt();
-  this->m_serialized_state = des.getString();
+
+  std::shared_ptr<SavedData> saved = std::make_shared<SavedData>();
+  saved->serialized = des.getString();
+  saved->depth = 0;
+  this->m_saved = saved;
 }
 
 
 /** Restores ALE to the given previously saved state. */ 
-void ALEState::load(OSystem* osystem, RomSettings* settings, std::string md5, const ALEState &rhs,
+void ALEState::load(OSystem* osystem, RomSettings* settings, const std::string& md5, const ALEState &rhs,
     bool load_system) {
-  assert(rhs.m_serialized_state.length() > 0);
-  
-  // Deserialize the stored string into the emulator state
-  Deserializer deser(rhs.m_serialized_state);
-
-  // A primitive check to produce a meaningful error if this state does not contain osystem info. 
-  if (deser.getBool() != load_system)
-    throw new std::runtime_error("Attempting to load an ALEState which does not contain "
-        "system information.");
-
-  osystem->console().system().loadState(md5, deser);
-  // If we have osystem data, load it as well
-  if (load_system)
-    osystem->loadState(deser);
-  settings->loadState(deser);
+  assert(rhs.m_saved);
+
+  // Deltas are first applied to their base to recover the full state
+  std::string buffer;
+  const std::string& serialized = rhs.getSerialized(buffer);
+  loadEmulator(osystem, settings, md5, serialized.data(), serialized.length(), load_system);
  
   // Copy over other member variables
   m_left_paddle = rhs.m_left_paddle; 
@@ -80,21 +133,242 @@ void ALEState::load(OSystem* osystem, RomSettings* settings, std::string md5, co
   m_difficulty = rhs.m_difficulty;
 }
 
-ALEState ALEState::save(OSystem* osystem, RomSettings* settings, std::string md5, 
+void ALEState::load(OSystem* osystem, RomSettings* settings, const std::string& md5,
+    const char* serialized, size_t size, bool load_system) {
+  // Same layout as serialize(), but the emulator state is read where it lies
+  Deserializer des(serialized, (uInt32) size);
+  int left_paddle = des.getInt();
+  int right_paddle = des.getInt();
+  int frame_number = des.getInt();
+  int episode_frame_number = des.getInt();
+  int mode = des.getInt();
+  int difficulty = des.getInt();
+  uInt32 length = (uInt32) des.getInt();
+  const char* data = (const char*) des.getBlock(length);
+
+  loadEmulator(osystem, settings, md5, data, length, load_system);
+
+  m_left_paddle = left_paddle;
+  m_right_paddle = right_paddle;
+  m_frame_number = frame_number;
+  m_episode_frame_number = episode_frame_number;
+  m_mode = mode;
+  m_difficulty = difficulty;
+}
+
+void ALEState::loadEmulator(OSystem* osystem, RomSettings* settings, const std::string& md5,
+    const char* data, size_t size, bool load_system) {
+  // Deserialize the stored data into the emulator state
+  Deserializer deser(data, (uInt32) size);
+
+  if (deser.getInt() == (int)ALE_SNAPSHOT_PATTERN) {
+    // A snapshot never contains system information
+    if (load_system)
+      throw new std::runtime_error("Attempting to load an ALEState which does not contain "
+          "system information.");
+
+    // As in System::loadState, refuse a state saved for a different cartridge
+    uInt32 md5_length = (uInt32) deser.getInt();
+    if (md5_length != md5.length() || memcmp(deser.getBlock(md5_length), md5.data(), md5_length) != 0)
+      throw new std::runtime_error("Attempting to load an ALEState saved for a different ROM.");
+
+    // Snapshots saved under another CPU core or cartridge scheme have a different layout
+    System& system = osystem->console().system();
+    uInt32 snapshot_size = (uInt32) deser.getInt();
+    uInt32 snapshot_layout = (uInt32) deser.getInt();
+    if (snapshot_size != system.snapshotSize() || snapshot_layout != system.snapshotLayout())
+      throw new std::runtime_error("Attempting to load an ALEState saved with a different "
+          "emulator configuration.");
+
+    system.loadSnapshot(deser.getBlock(snapshot_size));
+    settings->loadState(deser);
+    if (!deser.atEnd())
+      throw new std::runtime_error("Attempting to load an ALEState with trailing data.");
+  }
+  else {
+    Deserializer legacy(data, (uInt32) size);
+
+    // A primitive check to produce a meaningful error if this state does not contain osystem info. 
+    if (legacy.getBool() != load_system)
+      throw new std::runtime_error("Attempting to load an ALEState which does not contain "
+          "system information.");
+
+    osystem->console().system().loadState(md5, legacy);
+    // If we have osystem data, load it as well
+    if (load_system)
+      osystem->loadState(legacy);
+    settings->loadState(legacy);
+  }
+}
+
+ALEState ALEState::save(OSystem* osystem, RomSettings* settings, const std::string& md5, 
     bool save_system) {
-  // Use the emulator's built-in serialization to save the state
-  Serializer ser; 
-  
-  // We use 'save_system' as a check at load time. 
-  ser.putBool(save_system);
+  ALEState state;
+  save(osystem, settings, md5, save_system, state);
+  return state;
+}
+
+void ALEState::save(OSystem* osystem, RomSettings* settings, const std::string& md5,
+    bool save_system, ALEState &state) {
+  System& system = osystem->console().system();
+
+  // Reuse the storage of state if nothing else refers to it
+  std::shared_ptr<SavedData> saved;
+  if (state.m_saved && state.m_saved.use_count() == 1)
+    saved = state.m_saved;
+  else {
+    saved = std::make_shared<SavedData>();
+    // Snapshots have a fixed size; the extra space is for the header and the game's own state
+    saved->serialized.reserve(system.snapshotSize() + md5.length() + 256);
+  }
+  saved->base.reset();
+  saved->depth = 0;
+  saved->frames.clear();
+
+  // Write straight into the saved data's buffer
+  Serializer ser;
+  ser.swap(saved->serialized);
+  ser.close();
+
+  if (!save_system) {
+    // Copy the emulator state as a single fixed-layout snapshot block
+    ser.putInt(ALE_SNAPSHOT_PATTERN);
+    ser.putInt(md5.length());
+    memcpy(ser.putBlock(md5.length()), md5.data(), md5.length());
+    // The layout identifies the CPU core and devices the block was saved with
+    ser.putInt(system.snapshotSize());
+    ser.putInt(system.snapshotLayout());
+    system.saveSnapshot(ser.putBlock(system.snapshotSize()));
+    settings->saveState(ser);
+  }
+  else {
+    // Use the emulator's built-in serialization to save the state
+    // We use 'save_system' as a check at load time. 
+    ser.putBool(save_system);
 
-  osystem->console().system().saveState(md5, ser);
-  if (save_system)
+    system.saveState(md5, ser);
     osystem->saveState(ser);
-  settings->saveState(ser);
+    settings->saveState(ser);
+  }
+
+  ser.swap(saved->serialized);
 
   // Now make a copy of this state, also storing the emulator serialization
-  return ALEState(*this, ser.get_str());
+  state = *this;
+  state.m_saved = saved;
+}
+
+uint64_t ALEState::hash(OSystem* osystem, RomSettings* settings, std::string& buffer) const {
+  System& system = osystem->console().system();
+
+  // Lay out the same fixed-size snapshot as save() into the reused buffer
+  Serializer ser;
+  ser.swap(buffer);
+  ser.close();
+
+  system.saveSnapshot(ser.putBlock(system.snapshotSize()));
+  settings->saveState(ser);
+  ser.putInt(m_left_paddle);
+  ser.putInt(m_right_paddle);
+  ser.putInt(m_mode);
+  ser.putInt(m_difficulty);
+
+  ser.swap(buffer);
+
+  return hashBytes((const unsigned char*) buffer.data(), buffer.length());
+}
+
+ALEState ALEState::deltaFrom(const ALEState &base) const {
+  assert(m_saved && !m_saved->base);
+
+  if (!base.m_saved || base.m_saved->depth >= MAX_DELTA_DEPTH)
+    return *this;
+
+  std::string buffer;
+  const std::string& target = m_saved->serialized;
+  const std::string& source = base.getSerialized(buffer);
+
+  // Only snapshots of the same layout can be compared chunk by chunk
+  if (source.length() != target.length() || target.length() < sizeof(uInt32) ||
+      Deserializer(target).getInt() != (int)ALE_SNAPSHOT_PATTERN)
+    return *this;
+
+  // Store each run of changed chunks as its offset, its length and its bytes
+  Serializer ser;
+  size_t length = target.length();
+  size_t offset = 0;
+  while (offset < length) {
+    size_t size = std::min(DELTA_CHUNK_SIZE, length - offset);
+    if (memcmp(source.data() + offset, target.data() + offset, size) == 0) {
+      offset += size;
+      continue;
+    }
+
+    size_t start = offset;
+    offset += size;
+    while (offset < length) {
+      size = std::min(DELTA_CHUNK_SIZE, length - offset);
+      if (memcmp(source.data() + offset, target.data() + offset, size) == 0)
+        break;
+      offset += size;
+    }
+
+    ser.putInt(start);
+    ser.putInt(offset - start);
+    memcpy(ser.putBlock(offset - start), target.data() + start, offset - start);
+  }
+
+  std::shared_ptr<SavedData> saved = std::make_shared<SavedData>();
+  saved->serialized = ser.get_str();
+  saved->base = base.m_saved;
+  saved->depth = base.m_saved->depth + 1;
+  // Only the pointers to the frames are copied
+  saved->frames = m_saved->frames;
+
+  ALEState delta(*this);
+  delta.m_saved = saved;
+  return delta;
+}
+
+const std::string& ALEState::getSerialized(std::string& buffer) const {
+  static const std::string empty;
+
+  if (!m_saved)
+    return empty;
+  if (!m_saved->base)
+    return m_saved->serialized;
+
+  resolve(*m_saved, buffer);
+  return buffer;
+}
+
+void ALEState::resolve(const SavedData& saved, std::string& out) {
+  if (!saved.base) {
+    out = saved.serialized;
+    return;
+  }
+
+  resolve(*saved.base, out);
+
+  // Overwrite the base with each stored run
+  Deserializer deser(saved.serialized);
+  for (size_t read = 0; read < saved.serialized.length(); ) {
+    uInt32 offset = (uInt32) deser.getInt();
+    uInt32 size = (uInt32) deser.getInt();
+    memcpy(&out[offset], deser.getBlock(size), size);
+    read += 2 * sizeof(uInt32) + size;
+  }
+}
+
+void ALEState::setFrames(const Frames& frames) {
+  // Saved data is shared once the state is copied, so it may only be completed right after save()
+  assert(m_saved && m_saved.use_count() == 1);
+  m_saved->frames = frames;
+}
+
+const ALEState::Frames& ALEState::getFrames() const {
+  static const Frames empty;
+  return m_saved ? m_saved->frames : empty;
 }
 
 void ALEState::incrementFrame(int steps /* = 1 */) {
@@ -106,7 +380,7 @@ void ALEState::resetEpisodeFrameNumber() {
     m_episode_frame_number = 0;
 }
 
-std::string ALEState::serialize() {
+std::string ALEState::serialize() const {
   Serializer ser;
 
   ser.putInt(this->m_left_paddle);
@@ -115,7 +389,9 @@ std::string ALEState::serialize() {
   ser.putInt(this->m_episode_frame_number);
   ser.putInt(this->m_mode);
   ser.putInt(this->m_difficulty);
-  ser.putString(this->m_serialized_state);
+  // Deltas are stored in full, so that the result does not depend on other states
+  std::string buffer;
+  ser.putString(getSerialized(buffer));
 
   return ser.get_str();
 }
@@ -510,17 +786,13 @@ void ALEState::resetKeys(Event* event) {
 }
 
 bool ALEState::equals(ALEState &rhs) {
-  return (rhs.m_serialized_state == this->m_serialized_state &&
-    rhs.m_left_paddle == this->m_left_paddle &&
-    rhs.m_right_paddle == this->m_right_paddle &&
-    rhs.m_frame_number == this->m_frame_number &&
-    rhs.m_episode_frame_number == this->m_episode_frame_number &&
-    rhs.m_mode == this->m_mode &&
-    rhs.m_difficulty == this->m_difficulty);
+  return static_cast<const ALEState&>(*this).equals(rhs);
 }
 
 bool ALEState::equals(const ALEState &rhs) const {
-  return (rhs.m_serialized_state == this->m_serialized_state &&
+  // Compare the full states, since either may be stored as a delta
+  std::string lhs_buffer, rhs_buffer;
+  return (rhs.getSerialized(rhs_buffer) == this->getSerialized(lhs_buffer) &&
     rhs.m_left_paddle == this->m_left_paddle &&
     rhs.m_right_paddle == this->m_right_paddle &&
     rhs.m_frame_number == this->m_frame_number &&
@@ -20,7 +20,10 @@
 
 #include "../emucore/OSystem.hxx"
 #include "../emucore/Event.hxx"
+#include <memory>
+#include <stdint.h>
 #include <string>
+#include <vector>
 #include "../common/Log.hpp"
 
 class RomSettings;
@@ -33,8 +36,16 @@ class RomSettings;
 #define PADDLE_MAX 790196 
 #define PADDLE_DEFAULT_VALUE (((PADDLE_MAX - PADDLE_MIN) / 2) + PADDLE_MIN)
 
+// Marks a state saved as a raw emulator snapshot rather than serialized;
+// distinct from the Serializer's true and false patterns
+#define ALE_SNAPSHOT_PATTERN 0x5ab15ab2
+
 class ALEState {
   public:
+    /** A frame stack, oldest frame first. Frames are immutable and shared, so that the states
+      *  saved at consecutive steps share all but their newest frame. */
+    typedef std::vector<std::shared_ptr<const std::string> > Frames;
+
     ALEState();
     // Makes a copy of this state, also storing emulator information provided as a string
     ALEState(const ALEState &rhs, const std::string &serialized);
@@ -86,7 +97,10 @@ class ALEState {
     //Get the current mode we are in.
     game_mode_t getCurrentMode() const { return m_mode; }
 
-    std::string serialize();
+    std::string serialize() const;
+
+    /** Returns true if this state only stores its differences from another state */
+    bool isDelta() const { return m_saved && m_saved->base; }
 
 
   protected:
@@ -96,12 +110,40 @@ class ALEState {
     // The two methods below are meant to be used by StellaEnvironment.
     /** Restores the environment to a previously saved state. If load_system == true, we also
         restore system-specific information (such as the RNG state). */ 
-    void load(OSystem* osystem, RomSettings* settings, std::string md5, const ALEState &rhs,
+    void load(OSystem* osystem, RomSettings* settings, const std::string& md5, const ALEState &rhs,
               bool load_system);
+    /** As above, but restores the state from the output of serialize(), read in place */
+    void load(OSystem* osystem, RomSettings* settings, const std::string& md5,
+              const char* serialized, size_t size, bool load_system);
 
     /** Returns a "copy" of the current state, including the information necessary to restore
-      *  the emulator. If save_system == true, this includes the RNG state. */
-    ALEState save(OSystem* osystem, RomSettings* settings, std::string md5, bool save_system);
+      *  the emulator. If save_system == true, this includes the RNG state and the emulator is
+      *  serialized portably; otherwise it is copied as a raw snapshot, which can only be
+      *  restored by the same build of ALE on the same kind of machine. Snapshots record the
+      *  size and layout of the emulator's block, which load() checks. */
+    ALEState save(OSystem* osystem, RomSettings* settings, const std::string& md5, bool save_system);
+
+    /** As above, but stores the copy into state. The storage of state is reused when no other
+      *  state shares it, so that cloning into the same state repeatedly does not allocate. */
+    void save(OSystem* osystem, RomSettings* settings, const std::string& md5, bool save_system,
+              ALEState &state);
+
+    /** Returns a 64-bit hash of the state save() stores when save_system == false: the emulator
+      *  snapshot, the game's own state, the paddles, mode and difficulty. Frame numbers and the
+      *  frame stack are left out, so that the same state reached at different times hashes the
+      *  same. Like snapshots, hashes are only comparable within the same build of ALE on the
+      *  same kind of machine. buffer is scratch space, kept by the caller to avoid allocating. */
+    uint64_t hash(OSystem* osystem, RomSettings* settings, std::string& buffer) const;
+
+    /** Returns a copy of this saved state which only stores the chunks of the emulator snapshot
+      *  that differ from base, and shares base's data. If either state is not a snapshot, or
+      *  base is already at the end of a long chain of deltas, the copy is a full state. */
+    ALEState deltaFrom(const ALEState &base) const;
+
+    /** Stores the frame stack along with a state just returned by save() */
+    void setFrames(const Frames& frames);
+    /** Returns the stored frame stack; empty if there is none */
+    const Frames& getFrames() const;
 
     /** Reset key presses */
     void resetKeys(Event* event_obj);
@@ -125,7 +167,24 @@ class ALEState {
     int m_frame_number; // How many frames since the start
     int m_episode_frame_number; // How many frames since the beginning of this episode
 
-    std::string m_serialized_state; // The stored environment state, if this is a saved state
+    // The stored environment state of a saved state. It is immutable, so that copies of the
+    //  state and the deltas built on top of it can share it.
+    struct SavedData {
+      std::string serialized; // The full serialized state, or the changed chunks of a delta
+      std::shared_ptr<const SavedData> base; // The state a delta applies to, NULL otherwise
+      int depth; // Number of deltas between this state and a full state
+      Frames frames; // The frame stack when the state was saved, if frame stacking is on
+    };
+    // Only ever modified in place by save(), and only when no other state shares it
+    std::shared_ptr<SavedData> m_saved;
+
+    /** Restores the emulator from the stored environment state in data */
+    static void loadEmulator(OSystem* osystem, RomSettings* settings, const std::string& md5,
+                             const char* data, size_t size, bool load_system);
+
+    /** Returns the full serialized state, applying the chain of deltas into buffer if needed */
+    const std::string& getSerialized(std::string& buffer) const;
+    static void resolve(const SavedData& saved, std::string& out);
 
     game_mode_t m_mode; //The current mode we are in
     difficulty_t m_difficulty; //The current difficulty we are in
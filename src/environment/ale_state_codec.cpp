@@ -0,0 +1,307 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and 
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_state_codec.cpp
+ *
+ *  A compact encoding for batches of saved states, for keeping large archives
+ *   of states in memory or on disk.
+ *  
+ **************************************************************************** */
+
+#include "ale_state_codec.hpp"
+#include "../emucore/Deserializer.hxx"
+#include "../emucore/Serializer.hxx"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Identifies a block, and is followed by the version of the format
+static const char BLOCK_MAGIC[4] = { 'A', 'L', 'E', 'Z' };
+static const unsigned char BLOCK_VERSION = 2;
+
+// How the stream of states is stored in a block
+static const unsigned char BLOCK_STORED = 0;
+static const unsigned char BLOCK_COMPRESSED = 1;
+
+// Number of int fields serialize() writes before the emulator data
+static const int NUM_FIELDS = 6;
+
+// Shortest match the compressor refers back to, and size of its table of recent positions
+static const size_t MIN_MATCH = 4;
+static const int HASH_BITS = 14;
+static const uint32_t NO_POSITION = 0xffffffff;
+
+/** The headers found in saved states. The compressor starts from them, so that a block's first
+  *  state can also refer back. States saved as snapshots, by cloneState(), start with the snapshot
+  *  pattern and the length of the ROM's md5; the md5 itself differs between ROMs, and is only
+  *  stored once per block as later states are XORed with the one before. System states, saved
+  *  by the Serializer, hold device names and boolean patterns.
+  *
+  *  Version 1 blocks were compressed from the Serializer headers alone. The snapshot header
+  *  comes first, so that those blocks still decode: matches count back from the input. */
+static const std::string& dictionary() {
+  static const std::string words = [] {
+    Serializer ser;
+    ser.putInt(ALE_SNAPSHOT_PATTERN);
+    ser.putInt(32);
+
+    static const char* const names[] = {
+      "System", "M6502Low", "M6502High", "TIA", "TIASound", "M6532", "Cartridge0840",
+      "Cartridge2K", "Cartridge3E", "Cartridge3F", "Cartridge4A50", "Cartridge4K", "CartridgeAR",
+      "CartridgeCV", "CartridgeDPC", "CartridgeE0", "CartridgeE7", "CartridgeF4", "CartridgeF4SC",
+      "CartridgeF6", "CartridgeF6SC", "CartridgeF8", "CartridgeF8SC", "CartridgeFASC",
+      "CartridgeFE", "CartridgeMB", "CartridgeMC", "CartridgeUA"
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+      ser.putString(names[i]);
+    ser.putBool(true);
+    ser.putBool(false);
+    return ser.get_str();
+  }();
+  return words;
+}
+
+static void putVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out += (char) (value | 0x80);
+    value >>= 7;
+  }
+  out += (char) value;
+}
+
+static uint64_t getVarint(const unsigned char* data, size_t size, size_t& pos) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (pos >= size)
+      throw new std::runtime_error("Truncated ALEState block.");
+    unsigned char byte = data[pos++];
+    value |= (uint64_t) (byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+  throw new std::runtime_error("Corrupted ALEState block.");
+}
+
+// Maps small negative and positive differences to small unsigned values
+static inline uint32_t zigzag(uint32_t value) {
+  return (value << 1) ^ (uint32_t) ((int32_t) value >> 31);
+}
+
+static inline uint32_t unzigzag(uint32_t value) {
+  return (value >> 1) ^ (0u - (value & 1));
+}
+
+static inline size_t hashAt(const unsigned char* data) {
+  uint32_t word;
+  memcpy(&word, data, sizeof(word));
+  return (word * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/** LZ-compresses input, appending it to out as a series of literal runs, each followed by a
+  *  match except for the last: varint run length, run bytes, varint match length beyond
+  *  MIN_MATCH and varint distance back to the match. Matches may reach into the dictionary. */
+static void compress(const std::string& input, std::string& out) {
+  std::string window = dictionary() + input;
+  const unsigned char* data = (const unsigned char*) window.data();
+  size_t start = dictionary().length();
+  size_t end = window.length();
+
+  std::vector<uint32_t> table(1 << HASH_BITS, NO_POSITION);
+  for (size_t p = 0; p + MIN_MATCH <= start; p++)
+    table[hashAt(data + p)] = p;
+
+  size_t literals = start;
+  size_t p = start;
+  while (p + MIN_MATCH <= end) {
+    uint32_t& slot = table[hashAt(data + p)];
+    uint32_t candidate = slot;
+    slot = p;
+    if (candidate == NO_POSITION || memcmp(data + candidate, data + p, MIN_MATCH) != 0) {
+      p++;
+      continue;
+    }
+
+    size_t length = MIN_MATCH;
+    while (p + length < end && data[candidate + length] == data[p + length])
+      length++;
+
+    putVarint(out, p - literals);
+    out.append(window, literals, p - literals);
+    putVarint(out, length - MIN_MATCH);
+    putVarint(out, p - candidate);
+
+    for (size_t q = p + 1; q < p + length && q + MIN_MATCH <= end; q++)
+      table[hashAt(data + q)] = q;
+    p += length;
+    literals = p;
+  }
+
+  putVarint(out, end - literals);
+  out.append(window, literals, end - literals);
+}
+
+/** Reverses compress(), returning the raw_size bytes it was given */
+static void decompress(const unsigned char* data, size_t size, size_t pos, uint64_t raw_size,
+    std::string& out) {
+  size_t start = dictionary().length();
+  std::string window;
+  window.reserve(start + raw_size);
+  window = dictionary();
+
+  while (pos < size) {
+    uint64_t run = getVarint(data, size, pos);
+    if (run > size - pos || window.length() - start + run > raw_size)
+      throw new std::runtime_error("Corrupted ALEState block.");
+    window.append((const char*) data + pos, run);
+    pos += run;
+    if (pos == size)
+      break;
+
+    uint64_t length = getVarint(data, size, pos) + MIN_MATCH;
+    uint64_t distance = getVarint(data, size, pos);
+    if (distance == 0 || distance > window.length() ||
+        window.length() - start + length > raw_size)
+      throw new std::runtime_error("Corrupted ALEState block.");
+
+    // Matches may overlap the bytes they produce, so each copy only takes the bytes which
+    //  already exist, which doubles them until the match is complete
+    size_t from = window.length() - distance;
+    while (length > 0) {
+      size_t chunk = (size_t) std::min<uint64_t>(length, window.length() - from);
+      window.append(window, from, chunk);
+      from += chunk;
+      length -= chunk;
+    }
+  }
+
+  if (window.length() - start != raw_size)
+    throw new std::runtime_error("Corrupted ALEState block.");
+  out.assign(window, start, std::string::npos);
+}
+
+/** Reads the header of a block, returning the position of the stream that follows it */
+static size_t readHeader(const unsigned char* data, size_t size, unsigned char& method,
+    uint64_t& count, uint64_t& raw_size) {
+  if (size < sizeof(BLOCK_MAGIC) + 2 || memcmp(data, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0)
+    throw new std::runtime_error("Not an ALEState block.");
+  if (data[sizeof(BLOCK_MAGIC)] != BLOCK_VERSION && data[sizeof(BLOCK_MAGIC)] != 1)
+    throw new std::runtime_error("Unsupported ALEState block version.");
+
+  size_t pos = sizeof(BLOCK_MAGIC) + 1;
+  method = data[pos++];
+  if (method != BLOCK_STORED && method != BLOCK_COMPRESSED)
+    throw new std::runtime_error("Corrupted ALEState block.");
+  count = getVarint(data, size, pos);
+  raw_size = getVarint(data, size, pos);
+  return pos;
+}
+
+void ALEStateCodec::encode(const ALEState* const* states, size_t count, std::string& block) {
+  // Lay the states out as one stream of field differences and XORed emulator data
+  std::string stream;
+  int previous_fields[NUM_FIELDS] = { 0 };
+  std::string previous_data;
+  for (size_t i = 0; i < count; i++) {
+    std::string serialized = states[i]->serialize();
+    Deserializer deser(serialized);
+
+    for (int f = 0; f < NUM_FIELDS; f++) {
+      int field = deser.getInt();
+      putVarint(stream, zigzag((uint32_t) field - (uint32_t) previous_fields[f]));
+      previous_fields[f] = field;
+    }
+
+    std::string data = deser.getString();
+    putVarint(stream, data.length());
+    size_t offset = stream.length();
+    stream += data;
+    if (data.length() == previous_data.length()) {
+      for (size_t b = 0; b < data.length(); b++)
+        stream[offset + b] ^= previous_data[b];
+    }
+    previous_data.swap(data);
+  }
+
+  block.clear();
+  block.append(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+  block += (char) BLOCK_VERSION;
+  size_t method = block.length();
+  block += (char) BLOCK_COMPRESSED;
+  putVarint(block, count);
+  putVarint(block, stream.length());
+
+  size_t header = block.length();
+  compress(stream, block);
+
+  // Never store more than the stream itself
+  if (block.length() - header > stream.length()) {
+    block.resize(header);
+    block += stream;
+    block[method] = (char) BLOCK_STORED;
+  }
+}
+
+size_t ALEStateCodec::maxEncodedSize(size_t serialized_length, size_t count) {
+  // Each state's six fields and data length take at most 40 bytes in the stream, against the 28
+  //  they take in serialize(); the header takes at most 26
+  return serialized_length + 12 * count + 26;
+}
+
+size_t ALEStateCodec::count(const char* block, size_t size) {
+  unsigned char method;
+  uint64_t count, raw_size;
+  readHeader((const unsigned char*) block, size, method, count, raw_size);
+  return count;
+}
+
+void ALEStateCodec::decode(const char* block, size_t size, std::vector<ALEState>& states) {
+  const unsigned char* data = (const unsigned char*) block;
+  unsigned char method;
+  uint64_t count, raw_size;
+  size_t pos = readHeader(data, size, method, count, raw_size);
+
+  std::string stream;
+  if (method == BLOCK_STORED) {
+    if (size - pos != raw_size)
+      throw new std::runtime_error("Corrupted ALEState block.");
+    stream.assign(block + pos, size - pos);
+  }
+  else
+    decompress(data, size, pos, raw_size, stream);
+
+  const unsigned char* bytes = (const unsigned char*) stream.data();
+  size_t length = stream.length();
+  pos = 0;
+
+  int fields[NUM_FIELDS] = { 0 };
+  std::string previous_data;
+  for (uint64_t i = 0; i < count; i++) {
+    Serializer ser;
+    for (int f = 0; f < NUM_FIELDS; f++) {
+      fields[f] = (int) ((uint32_t) fields[f] + unzigzag((uint32_t) getVarint(bytes, length, pos)));
+      ser.putInt(fields[f]);
+    }
+
+    uint64_t data_length = getVarint(bytes, length, pos);
+    if (data_length > length - pos)
+      throw new std::runtime_error("Corrupted ALEState block.");
+    std::string data(stream, pos, data_length);
+    pos += data_length;
+    if (data.length() == previous_data.length()) {
+      for (size_t b = 0; b < data.length(); b++)
+        data[b] ^= previous_data[b];
+    }
+
+    ser.putString(data);
+    states.push_back(ALEState(ser.get_str()));
+    previous_data.swap(data);
+  }
+}
@@ -0,0 +1,48 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and 
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_state_codec.hpp
+ *
+ *  A compact encoding for batches of saved states, for keeping large archives
+ *   of states in memory or on disk.
+ *  
+ **************************************************************************** */
+
+#ifndef __ALE_STATE_CODEC_HPP__
+#define __ALE_STATE_CODEC_HPP__
+
+#include "ale_state.hpp"
+
+#include <string>
+#include <vector>
+
+/** Encodes a batch of states into a single block, which stores the same information as
+  *  ALEState::serialize() for each of them. The fields of each state are stored as varints
+  *  relative to those of the previous state, and the emulator data as its XOR with the previous
+  *  state's whenever both have the same length. The block is then LZ-compressed, starting from a
+  *  dictionary of the headers every state contains. Batches of related states, such as
+  *  neighbouring nodes of a search tree, compress best. */
+class ALEStateCodec {
+  public:
+    /** Encodes count states into block, replacing its contents */
+    static void encode(const ALEState* const* states, size_t count, std::string& block);
+
+    /** Returns an upper bound on the size of the block encoding count states, given the total
+      *  length of their serialize() output */
+    static size_t maxEncodedSize(size_t serialized_length, size_t count);
+
+    /** Returns the number of states stored in a block */
+    static size_t count(const char* block, size_t size);
+
+    /** Decodes the states stored in a block, appending them to states */
+    static void decode(const char* block, size_t size, std::vector<ALEState>& states);
+};
+
+#endif // __ALE_STATE_CODEC_HPP__
@@ -0,0 +1,291 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ */
+#include "ale_state_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char STORE_MAGIC[8] = { 'A', 'L', 'E', 'S', 'T', 'O', 'R', 'E' };
+static const uint32_t STORE_VERSION = 1;
+
+// A segment starts with this header, followed by one entry per state it can hold
+struct SegmentHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t states;  // Number of states the segment holds when full
+  uint32_t count;   // Number of states appended so far; only ever grows
+  uint32_t reserved;
+};
+
+struct SegmentEntry {
+  uint64_t offset;  // Position of the serialized state in the segment file
+  uint64_t size;
+};
+
+/** Holds an exclusive lock on a file, shared with every other process using it */
+class FileLock {
+  public:
+    FileLock(int fd): m_fd(fd) {
+      while (flock(m_fd, LOCK_EX) != 0) {
+        if (errno != EINTR)
+          throw new std::runtime_error("Cannot lock the state store.");
+      }
+    }
+    ~FileLock() { flock(m_fd, LOCK_UN); }
+
+  private:
+    int m_fd;
+};
+
+static void writeAll(int fd, const void* data, size_t size, off_t offset) {
+  const char* bytes = (const char*) data;
+  while (size > 0) {
+    ssize_t written = pwrite(fd, bytes, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      throw new std::runtime_error("Cannot write to the state store.");
+    }
+    bytes += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+static const SegmentEntry* segmentTable(const char* data) {
+  return (const SegmentEntry*) (data + sizeof(SegmentHeader));
+}
+
+ALEStateStore::ALEStateStore(const std::string& path, bool writable, size_t states_per_segment):
+  m_path(path),
+  m_writable(writable),
+  m_states_per_segment(states_per_segment),
+  m_size(0) {
+  if (states_per_segment == 0 || states_per_segment > 0xffffffffu)
+    throw new std::runtime_error("Invalid number of states per segment.");
+
+  if (!openSegment(0)) {
+    if (!writable)
+      throw new std::runtime_error("Cannot open the state store " + segmentPath(0) + ".");
+    createSegment(0, states_per_segment);
+    if (!openSegment(0))
+      throw new std::runtime_error("Cannot open the state store " + segmentPath(0) + ".");
+  }
+
+  refresh();
+}
+
+ALEStateStore::~ALEStateStore() {
+  for (size_t i = 0; i < m_segments.size(); i++) {
+    munmap((void*) m_segments[i].data, m_segments[i].mapped);
+    close(m_segments[i].fd);
+  }
+  for (size_t i = 0; i < m_old_mappings.size(); i++)
+    munmap((void*) m_old_mappings[i].data, m_old_mappings[i].length);
+}
+
+size_t ALEStateStore::append(const ALEState& state) {
+  if (!m_writable)
+    throw new std::runtime_error("Attempting to append to a read-only state store.");
+
+  std::string record = state.serialize();
+
+  // Other processes may have appended states before the lock was taken
+  FileLock lock(m_segments[0].fd);
+  refresh();
+
+  size_t index = m_size;
+  size_t segment = index / m_states_per_segment;
+  size_t slot = index % m_states_per_segment;
+  if (segment == m_segments.size()) {
+    createSegment(segment, m_states_per_segment);
+    if (!openSegment(segment))
+      throw new std::runtime_error("Cannot open the state store " + segmentPath(segment) + ".");
+  }
+
+  // The state goes at the end of the segment file, past anything left by an interrupted append
+  int fd = m_segments[segment].fd;
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+    throw new std::runtime_error("Cannot read the state store " + segmentPath(segment) + ".");
+
+  SegmentEntry entry;
+  entry.offset = info.st_size;
+  entry.size = record.length();
+  writeAll(fd, record.data(), record.length(), info.st_size);
+  writeAll(fd, &entry, sizeof(entry), sizeof(SegmentHeader) + slot * sizeof(SegmentEntry));
+
+  // Readers only see the state once the count includes it, by which time it is complete
+  uint32_t count = slot + 1;
+  writeAll(fd, &count, sizeof(count), offsetof(SegmentHeader, count));
+
+  m_size = index + 1;
+  return index;
+}
+
+size_t ALEStateStore::size() {
+  refresh();
+  return m_size;
+}
+
+const char* ALEStateStore::get(size_t index, size_t& size) {
+  if (index >= m_size) {
+    refresh();
+    if (index >= m_size)
+      throw new std::runtime_error("Attempting to read past the end of the state store.");
+  }
+
+  Segment& segment = m_segments[index / m_states_per_segment];
+  const SegmentEntry& entry = segmentTable(segment.data)[index % m_states_per_segment];
+
+  // The last segment grows as states are appended to it
+  if (entry.offset + entry.size > segment.mapped) {
+    remap(segment);
+    if (entry.offset + entry.size > segment.mapped)
+      throw new std::runtime_error("The state store " + m_path + " is corrupt.");
+  }
+
+  size = entry.size;
+  return segment.data + entry.offset;
+}
+
+ALEState ALEStateStore::getState(size_t index) {
+  size_t size;
+  const char* data = get(index, size);
+  return ALEState(std::string(data, size));
+}
+
+std::string ALEStateStore::segmentPath(size_t segment) const {
+  std::ostringstream path;
+  path << m_path << "." << segment;
+  return path.str();
+}
+
+bool ALEStateStore::openSegment(size_t segment) {
+  std::string path = segmentPath(segment);
+  int fd = open(path.c_str(), m_writable ? O_RDWR : O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT)
+      return false;
+    throw new std::runtime_error("Cannot open the state store " + path + ".");
+  }
+
+  Segment mapping;
+  mapping.fd = fd;
+  mapping.data = NULL;
+  mapping.mapped = 0;
+  try {
+    remap(mapping);
+  }
+  catch (...) {
+    close(fd);
+    throw;
+  }
+
+  // Every segment has the layout of the first one, which is that of the whole store
+  const SegmentHeader* header = (const SegmentHeader*) mapping.data;
+  bool valid = mapping.mapped >= sizeof(SegmentHeader) &&
+      memcmp(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) == 0 &&
+      header->version == STORE_VERSION && header->states > 0 &&
+      (segment == 0 || header->states == m_states_per_segment) &&
+      mapping.mapped >= sizeof(SegmentHeader) + header->states * sizeof(SegmentEntry);
+  if (!valid) {
+    munmap((void*) mapping.data, mapping.mapped);
+    close(fd);
+    throw new std::runtime_error(path + " is not a state store segment.");
+  }
+
+  m_states_per_segment = header->states;
+  m_segments.push_back(mapping);
+  return true;
+}
+
+void ALEStateStore::createSegment(size_t segment, size_t states_per_segment) {
+  std::string path = segmentPath(segment);
+  std::ostringstream temporary;
+  temporary << path << ".tmp" << getpid();
+
+  // The segment is written in full under a temporary name first, so that it only appears
+  // under its own name once it is complete
+  int fd = open(temporary.str().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    throw new std::runtime_error("Cannot create the state store " + path + ".");
+
+  std::vector<char> table(sizeof(SegmentHeader) + states_per_segment * sizeof(SegmentEntry), 0);
+  SegmentHeader* header = (SegmentHeader*) &table[0];
+  memcpy(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+  header->version = STORE_VERSION;
+  header->states = states_per_segment;
+
+  try {
+    writeAll(fd, &table[0], table.size(), 0);
+  }
+  catch (...) {
+    close(fd);
+    unlink(temporary.str().c_str());
+    throw;
+  }
+  close(fd);
+
+  // If another process created the segment in the meantime, its copy is kept
+  int result = link(temporary.str().c_str(), path.c_str());
+  int error = errno;
+  unlink(temporary.str().c_str());
+  if (result != 0 && error != EEXIST)
+    throw new std::runtime_error("Cannot create the state store " + path + ".");
+}
+
+void ALEStateStore::remap(Segment& segment) {
+  struct stat info;
+  if (fstat(segment.fd, &info) != 0)
+    throw new std::runtime_error("Cannot read the state store " + m_path + ".");
+
+  size_t length = info.st_size;
+  if (length <= segment.mapped)
+    return;
+
+  // A growing segment is mapped at least twice as far as before, so that it is only remapped a
+  //  few times. Only the part of the mapping within the file is ever read.
+  length = std::max(length, 2 * segment.mapped);
+  void* data = mmap(NULL, length, PROT_READ, MAP_SHARED, segment.fd, 0);
+  if (data == MAP_FAILED)
+    throw new std::runtime_error("Cannot map the state store " + m_path + ".");
+
+  if (segment.data) {
+    Mapping old = { segment.data, segment.mapped };
+    m_old_mappings.push_back(old);
+  }
+  segment.data = (const char*) data;
+  segment.mapped = length;
+}
+
+void ALEStateStore::refresh() {
+  while (true) {
+    // Appends publish the count last, after the state and its table entry
+    const SegmentHeader* header = (const SegmentHeader*) m_segments.back().data;
+    size_t count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+    m_size = (m_segments.size() - 1) * m_states_per_segment + count;
+
+    // Only a full segment can be followed by another one
+    if (count < m_states_per_segment || !openSegment(m_segments.size()))
+      break;
+  }
+}
@@ -0,0 +1,100 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_state_store.hpp
+ *
+ *  An on-disk archive of saved states, read through memory mappings so that
+ *   many processes can share a single copy of it.
+ *
+ **************************************************************************** */
+
+#ifndef __ALE_STATE_STORE_HPP__
+#define __ALE_STATE_STORE_HPP__
+
+#include "ale_state.hpp"
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/** An append-only store of states, each kept as its ALEState::serialize() output. The store is
+  *  split into segment files path.0, path.1, ... of a fixed number of states each. A segment
+  *  starts with a table of where its states lie, so that any state is found in constant time.
+  *  Segments are mapped into memory read-only, and states are read in place from the mapping,
+  *  which the operating system shares between every process reading the store.
+  *
+  *  Any number of processes may read a store while others append to it: appends are serialized
+  *  by a lock on the first segment, and a state only becomes visible once it is complete. A
+  *  single ALEStateStore object must not be used from two threads at once.
+  *
+  *  States saved by cloneState() are raw snapshots, so a store of them can only be restored by
+  *  the same build of ALE on the same kind of machine; the segment tables are stored in the
+  *  machine's byte order as well. */
+class ALEStateStore {
+  public:
+    /** Number of states in each segment of a new store */
+    static const size_t DEFAULT_STATES_PER_SEGMENT = 4096;
+
+    /** Opens the store at path. A writable store is created if it does not exist yet, with
+      *  states_per_segment states in each segment; an existing store keeps its own layout. */
+    ALEStateStore(const std::string& path, bool writable = false,
+                  size_t states_per_segment = DEFAULT_STATES_PER_SEGMENT);
+    ~ALEStateStore();
+
+    /** Appends a state to the store and returns its index */
+    size_t append(const ALEState& state);
+
+    /** Returns the number of states in the store, including those appended by other processes
+      *  since it was opened */
+    size_t size();
+
+    /** Returns the serialized state at the given index and sets size to its length. The data
+      *  lies in the store's mapping and remains valid until the store is closed. */
+    const char* get(size_t index, size_t& size);
+
+    /** Returns a copy of the state at the given index */
+    ALEState getState(size_t index);
+
+  private:
+    struct Segment {
+      int fd;
+      const char* data; // The mapping of the segment file
+      size_t mapped;    // Length of the mapping, which may extend past the end of the file
+    };
+
+    struct Mapping {
+      const char* data;
+      size_t length;
+    };
+
+    std::string segmentPath(size_t segment) const;
+    /** Maps the given segment, returning false if it does not exist */
+    bool openSegment(size_t segment);
+    /** Creates the given segment, unless another process has already created it */
+    void createSegment(size_t segment, size_t states_per_segment);
+    /** Maps the whole of a segment file, which may have grown since it was last mapped. The
+      *  previous mapping is kept, as states returned by get() may still point into it. */
+    void remap(Segment& segment);
+    /** Picks up the states and segments appended since the last call */
+    void refresh();
+
+    // Stores are not copyable, as they own their file descriptors and mappings
+    ALEStateStore(const ALEStateStore&);
+    ALEStateStore& operator=(const ALEStateStore&);
+
+    std::string m_path;
+    bool m_writable;
+    size_t m_states_per_segment;
+    size_t m_size;
+    std::vector<Segment> m_segments;
+    std::vector<Mapping> m_old_mappings; // Mappings replaced by remap(), unmapped on close
+};
+
+#endif // __ALE_STATE_STORE_HPP__
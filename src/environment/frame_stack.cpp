@@ -0,0 +1,96 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and 
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  frame_stack.cpp
+ *
+ *  Keeps the last few preprocessed screens, so that agents can read a stacked
+ *  observation without managing their own history.
+ *  
+ **************************************************************************** */
+
+#include "frame_stack.hpp"
+#include "../common/Log.hpp"
+
+#include <cstring>
+
+FrameStack::FrameStack(OSystem * osystem, ScreenPreprocessor& preprocessor):
+  m_preprocessor(preprocessor),
+  m_next(0) {
+
+  int depth = osystem->settings().getInt("frame_stack");
+  if (depth < 0) {
+    ale::Logger::Warning << "Warning: frame stack set to < 0. Setting to 0." << std::endl;
+    depth = 0;
+  }
+  m_depth = depth;
+  m_frame_size = m_preprocessor.height() * m_preprocessor.width();
+  m_frames.resize(2 * m_depth * m_frame_size, 0);
+  m_shared.resize(m_depth);
+}
+
+void FrameStack::push() {
+  if (m_depth == 0) return;
+
+  // Write the new frame over the oldest one, then mirror it in the second copy of the ring
+  pixel_t* frame = &m_frames[m_next * m_frame_size];
+  m_preprocessor.process(frame);
+  memcpy(frame + m_depth * m_frame_size, frame, m_frame_size);
+  m_shared[m_next].reset();
+
+  m_next = (m_next + 1) % m_depth;
+}
+
+void FrameStack::fill() {
+  if (m_depth == 0) return;
+
+  m_preprocessor.process(&m_frames[0]);
+  for (size_t i = 1; i < 2 * m_depth; i++)
+    memcpy(&m_frames[i * m_frame_size], &m_frames[0], m_frame_size);
+
+  // Every slot holds the same frame, so they all share one copy
+  std::shared_ptr<const std::string> shared =
+      std::make_shared<const std::string>((const char*)&m_frames[0], m_frame_size);
+  for (size_t i = 0; i < m_depth; i++)
+    m_shared[i] = shared;
+
+  m_next = 0;
+}
+
+const ALEState::Frames& FrameStack::share() {
+  m_stack.resize(m_depth);
+  for (size_t i = 0; i < m_depth; i++) {
+    size_t slot = (m_next + i) % m_depth;
+    if (!m_shared[slot])
+      m_shared[slot] = std::make_shared<const std::string>(
+          (const char*)&m_frames[slot * m_frame_size], m_frame_size);
+    m_stack[i] = m_shared[slot];
+  }
+  return m_stack;
+}
+
+void FrameStack::load(const ALEState::Frames& frames) {
+  // States saved without frames, or with a different stack, restart it from the current screen
+  bool valid = frames.size() == m_depth;
+  for (size_t i = 0; valid && i < m_depth; i++)
+    valid = frames[i] && frames[i]->length() == m_frame_size;
+  if (!valid) {
+    fill();
+    return;
+  }
+
+  size_t size = m_depth * m_frame_size;
+  if (size == 0) return;
+  for (size_t i = 0; i < m_depth; i++) {
+    memcpy(&m_frames[i * m_frame_size], frames[i]->data(), m_frame_size);
+    m_shared[i] = frames[i];
+  }
+  memcpy(&m_frames[size], &m_frames[0], size);
+  m_next = 0;
+}
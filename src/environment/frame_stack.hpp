@@ -0,0 +1,77 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and 
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  frame_stack.hpp
+ *
+ *  Keeps the last few preprocessed screens, so that agents can read a stacked
+ *  observation without managing their own history.
+ *  
+ **************************************************************************** */
+
+#ifndef __FRAME_STACK_HPP__
+#define __FRAME_STACK_HPP__
+
+#include "../emucore/OSystem.hxx"
+#include "screen_preprocessor.hpp"
+#include "ale_state.hpp"
+
+#include <string>
+#include <vector>
+
+class FrameStack {
+  public:
+    /** Reads the frame_stack setting from the OSystem; frames are produced by preprocessor. */
+    FrameStack(OSystem *, ScreenPreprocessor& preprocessor);
+
+    /** Whether frame stacking is on, i.e. frame_stack > 0 */
+    bool enabled() const { return m_depth > 0; }
+
+    /** Number of frames in the stack, and size in bytes of each */
+    size_t depth() const { return m_depth; }
+    size_t frameSize() const { return m_frame_size; }
+
+    /** Preprocesses the current screen and pushes it, dropping the oldest frame */
+    void push();
+
+    /** Fills the whole stack with the current screen, e.g. at the start of an episode */
+    void fill();
+
+    /** Returns the stack as depth() contiguous frames, oldest first. The data is valid until
+      *  the next push() or fill(). */
+    const pixel_t* data() const {
+      return m_frames.empty() ? NULL : &m_frames[m_next * m_frame_size];
+    }
+
+    /** Returns the stack as frames to store in a saved state. Frames which were not pushed
+      *  since the last call are returned as the same shared buffers, so only new frames are
+      *  copied. The result is valid until the next call. */
+    const ALEState::Frames& share();
+
+    /** Restores a stack returned by share(); anything else restarts the stack with fill() */
+    void load(const ALEState::Frames& frames);
+
+  private:
+    ScreenPreprocessor& m_preprocessor;
+
+    size_t m_depth;
+    size_t m_frame_size;
+
+    // Ring of frames, stored twice in a row so that the last m_depth frames are always
+    //  contiguous; m_next is the slot of the oldest frame, which is overwritten next
+    std::vector<pixel_t> m_frames;
+    size_t m_next;
+
+    // The shared copy of the frame in each slot of the ring, NULL until share() makes one, and
+    //  the stack last returned by share()
+    ALEState::Frames m_shared;
+    ALEState::Frames m_stack;
+};
+
+#endif // __FRAME_STACK_HPP__
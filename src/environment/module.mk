@@ -2,8 +2,12 @@ MODULE := src/environment
 
 MODULE_OBJS := \
 	src/environment/ale_state.o \
+	src/environment/ale_state_codec.o \
+	src/environment/ale_state_store.o \
 	src/environment/stella_environment.o \
+	src/environment/frame_stack.o \
 	src/environment/phosphor_blend.o \
+	src/environment/screen_preprocessor.o \
 	
 MODULE_DIRS += \
 	src/environment
@@ -17,6 +17,73 @@
 #include "phosphor_blend.hpp"
 #include "../emucore/Console.hxx"
 
+#include <string.h>
+
+// As for the palette kernels, the vectorized blend is compiled for AVX2 whatever the build flags,
+//  and only used after checking at runtime that the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALE_PHOSPHOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+typedef void (*BlendKernel)(uInt8* dst_buffer, const uInt8* current_buffer,
+    const uInt8* previous_buffer, size_t size, const uInt8* avg_index);
+
+static void blendScalar(uInt8* dst_buffer, const uInt8* current_buffer,
+    const uInt8* previous_buffer, size_t size, const uInt8* avg_index) {
+  for (size_t i = 0; i < size; i++) {
+    dst_buffer[i] = avg_index[(current_buffer[i] << 8) | previous_buffer[i]];
+  }
+}
+
+#ifdef ALE_PHOSPHOR_X86_KERNELS
+/** Gathers the blended colours of 32 pixels at a time and narrows them to bytes. */
+__attribute__((target("avx2")))
+static void blendAVX2(uInt8* dst_buffer, const uInt8* current_buffer,
+    const uInt8* previous_buffer, size_t size, const uInt8* avg_index) {
+  const int* table = (const int*)avg_index;
+  const __m256i low_byte = _mm256_set1_epi32(0xFF);
+  // Undoes the lane interleaving of the two packs below
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i index[4];
+    for (int k = 0; k < 4; k++) {
+      __m256i current = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i*)(current_buffer + i + 8 * k)));
+      __m256i previous = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i*)(previous_buffer + i + 8 * k)));
+      index[k] = _mm256_or_si256(_mm256_slli_epi32(current, 8), previous);
+    }
+
+    // Scale 1: each entry is the low byte of the word read at its own address
+    __m256i a = _mm256_and_si256(_mm256_i32gather_epi32(table, index[0], 1), low_byte);
+    __m256i b = _mm256_and_si256(_mm256_i32gather_epi32(table, index[1], 1), low_byte);
+    __m256i c = _mm256_and_si256(_mm256_i32gather_epi32(table, index[2], 1), low_byte);
+    __m256i d = _mm256_and_si256(_mm256_i32gather_epi32(table, index[3], 1), low_byte);
+
+    __m256i ab = _mm256_packus_epi32(a, b);
+    __m256i cd = _mm256_packus_epi32(c, d);
+    __m256i blended = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), order);
+
+    _mm256_storeu_si256((__m256i*)(dst_buffer + i), blended);
+  }
+
+  blendScalar(dst_buffer + i, current_buffer + i, previous_buffer + i, size - i, avg_index);
+}
+#endif
+
+/** Picks the fastest blend kernel this CPU supports. */
+static BlendKernel selectBlendKernel() {
+#ifdef ALE_PHOSPHOR_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return blendAVX2;
+#endif
+  return blendScalar;
+}
+
 PhosphorBlend::PhosphorBlend(OSystem * osystem):
     m_osystem(osystem) {
   
@@ -27,29 +94,24 @@ PhosphorBlend::PhosphorBlend(OSystem * osystem):
 }
 
 void PhosphorBlend::process(ALEScreen& screen) {
+  static const BlendKernel kernel = selectBlendKernel();
+
   Console& console = m_osystem->console();
 
   // Fetch current and previous frame buffers from the emulator
   uInt8 * current_buffer  = console.mediaSource().currentFrameBuffer();
   uInt8 * previous_buffer = console.mediaSource().previousFrameBuffer();
 
-  // Process each pixel in turn
-  for (size_t i = 0; i < screen.arraySize(); i++) { 
-    int cv = current_buffer[i];
-    int pv = previous_buffer[i];
-    
-    // Find out the corresponding rgb color 
-    uInt32 rgb = m_avg_palette[cv][pv];
-
-    // Set the corresponding pixel in the array
-    screen.getArray()[i] = rgbToNTSC(rgb);
-  }
+  // Look up the blended colour of each pixel
+  kernel(screen.getArray(), current_buffer, previous_buffer, screen.arraySize(), m_avg_index);
 }
+
 void PhosphorBlend::makeAveragePalette() {
   
   ColourPalette &palette = m_osystem->colourPalette();
 
-  // Precompute the average RGB values for phosphor-averaged colors c1 and c2.
+  // Precompute the NTSC colour closest to the average of colours c1 and c2. Odd palette entries
+  //  correspond to grayscale values; they are blended as the colour below them.
   for (int c1 = 0; c1 < 256; c1 += 2) {
     for (int c2 = 0; c2 < 256; c2 += 2) {
       int r1, g1, b1;
@@ -60,37 +122,15 @@ void PhosphorBlend::makeAveragePalette() {
       uInt8 r = getPhosphor(r1, r2);
       uInt8 g = getPhosphor(g1, g2);
       uInt8 b = getPhosphor(b1, b2);
-      m_avg_palette[c1][c2] = makeRGB(r, g, b);
-    }
-  }
-  
-  // Also make a RGB to NTSC color map. We drop the lowest two bits to speed
-  // the initialization a little. TODO(mgbellemare): Find a better solution.
-  for (int r = 0; r < 256; r += 4) {
-    for (int g = 0; g < 256; g += 4) {  
-      for (int b = 0; b < 256; b += 4) {
-        // For each RGB point, we find its closest NTSC match
-        int minDist = 256 * 3 + 1;
-        int minIndex = -1;
-
-        // Look for the closest NTSC value matching (r,g,b). Odd palette
-        // entries correspond to grayscale values and are ignored.
-        for (int c1 = 0; c1 < 256; c1 += 2) {
-          // Get the RGB corresponding to c1
-          int r1, g1, b1;
-          palette.getRGB(c1, r1, g1, b1);
-
-          int dist = abs(r1 - r) + abs(g1 - g) + abs(b1 - b);
-          if (dist < minDist) {
-            minDist = dist;
-            minIndex = c1;
-          }
-        }
-
-        m_rgb_ntsc[r >> 2][g >> 2][b >> 2] = minIndex;
-      }
+      uInt8 index = rgbToNTSC(r, g, b);
+
+      m_avg_index[c1 * 256 + c2] = index;
+      m_avg_index[c1 * 256 + c2 + 1] = index;
+      m_avg_index[(c1 + 1) * 256 + c2] = index;
+      m_avg_index[(c1 + 1) * 256 + c2 + 1] = index;
     }
   }
+  memset(m_avg_index + 256 * 256, 0, sizeof(m_avg_index) - 256 * 256);
 }
 
 uInt8 PhosphorBlend::getPhosphor(uInt8 v1, uInt8 v2) {
@@ -105,16 +145,31 @@ uInt8 PhosphorBlend::getPhosphor(uInt8 v1, uInt8 v2) {
   else return (uInt8) blendedValue;
 }
 
-uInt32 PhosphorBlend::makeRGB(uInt8 r, uInt8 g, uInt8 b) {
-  return (r << 16) | (g << 8) | b;
-}
+/** Returns the NTSC color closest to the given RGB value */
+uInt8 PhosphorBlend::rgbToNTSC(int r, int g, int b) {
+  // The lowest two bits are dropped, as the colours were historically matched through a
+  //  64x64x64 table
+  r &= ~3;
+  g &= ~3;
+  b &= ~3;
 
-/** Converts a RGB value to an 8-bit format */
-uInt8 PhosphorBlend::rgbToNTSC(uInt32 rgb) {
-  int r = (rgb >> 16) & 0xFF;
-  int g = (rgb >> 8) & 0xFF;
-  int b = rgb & 0xFF;
+  int minDist = 256 * 3 + 1;
+  int minIndex = -1;
 
-  return m_rgb_ntsc[r >> 2][g >> 2][b >> 2];
-}
+  // Look for the closest NTSC value matching (r,g,b). Odd palette
+  // entries correspond to grayscale values and are ignored.
+  ColourPalette &palette = m_osystem->colourPalette();
+  for (int c1 = 0; c1 < 256; c1 += 2) {
+    // Get the RGB corresponding to c1
+    int r1, g1, b1;
+    palette.getRGB(c1, r1, g1, b1);
+
+    int dist = abs(r1 - r) + abs(g1 - g) + abs(b1 - b);
+    if (dist < minDist) {
+      minDist = dist;
+      minIndex = c1;
+    }
+  }
 
+  return minIndex;
+}
@@ -29,16 +29,16 @@ class PhosphorBlend {
   private:
     void makeAveragePalette();
     uInt8 getPhosphor(uInt8 v1, uInt8 v2);
-    uInt32 makeRGB(uInt8 r, uInt8 g, uInt8 b);
-    /** Converts a RGB value to an 8-bit format */
-    uInt8 rgbToNTSC(uInt32 rgb);
+    /** Returns the NTSC color closest to the given RGB value */
+    uInt8 rgbToNTSC(int r, int g, int b);
     
   private:
     OSystem * m_osystem;
 
-    uInt8 m_rgb_ntsc[64][64][64];
-
-    uInt32 m_avg_palette[256][256];
+    // The palette index of the phosphor blend of colours c1 and c2 is
+    //  m_avg_index[c1 * 256 + c2]. The last bytes are padding, so that the blend kernels can read
+    //  any entry as the low byte of a 32-bit word.
+    uInt8 m_avg_index[256 * 256 + 3];
     uInt8 m_phosphor_blend_ratio;
 };
 
@@ -0,0 +1,164 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and 
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  screen_preprocessor.cpp
+ *
+ *  Turns the emulator's frame buffers into a grayscale, optionally max-pooled
+ *  and resized observation in a single pass.
+ *  
+ **************************************************************************** */
+
+#include "screen_preprocessor.hpp"
+#include "../common/Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+ScreenPreprocessor::ScreenPreprocessor(OSystem * osystem):
+  m_osystem(osystem) {
+
+  MediaSource& media = m_osystem->console().mediaSource();
+  m_src_height = media.height();
+  m_src_width = media.width();
+
+  m_max_pool = m_osystem->settings().getBool("preprocess_max_pool");
+
+  // 0 keeps the emulator's dimension
+  int height = m_osystem->settings().getInt("preprocess_height");
+  int width = m_osystem->settings().getInt("preprocess_width");
+  if (height < 0 || width < 0) {
+    ale::Logger::Warning << "Warning: negative preprocess_height or preprocess_width. "
+      "Keeping the screen size." << std::endl;
+  }
+  m_height = height > 0 ? height : m_src_height;
+  m_width = width > 0 ? width : m_src_width;
+
+  // Screens only hold even palette indices; the grayscale entry follows each colour
+  for (int i = 0; i < 256; i++) {
+    m_grayscale[i] = m_osystem->colourPalette().getRGB((i & ~1) + 1) & 0xFF;
+  }
+
+  makeTaps(m_src_height, m_height, m_row_taps, m_row_offsets);
+
+  // Columns are resampled with the same number of taps each, padded with zero weights, so
+  //  that the inner loop has a fixed length
+  std::vector<Tap> column_taps;
+  std::vector<int> column_offsets;
+  makeTaps(m_src_width, m_width, column_taps, column_offsets);
+
+  m_column_taps = 0;
+  for (size_t c = 0; c < m_width; c++) {
+    m_column_taps = std::max(m_column_taps, (size_t)(column_offsets[c + 1] - column_offsets[c]));
+  }
+  m_column_index.assign(m_width * m_column_taps, 0);
+  m_column_weight.assign(m_width * m_column_taps, 0.0f);
+  for (size_t c = 0; c < m_width; c++) {
+    for (int t = column_offsets[c]; t < column_offsets[c + 1]; t++) {
+      size_t k = c * m_column_taps + (t - column_offsets[c]);
+      m_column_index[k] = column_taps[t].index;
+      m_column_weight[k] = column_taps[t].weight;
+    }
+  }
+
+  m_row.resize(m_src_width);
+  m_accumulator.resize(m_src_width);
+}
+
+void ScreenPreprocessor::makeTaps(size_t src_size, size_t dst_size, std::vector<Tap>& taps,
+    std::vector<int>& offsets) {
+  taps.clear();
+  offsets.clear();
+
+  // Destination pixel i covers [i * scale, (i + 1) * scale) in source pixels; each source
+  //  pixel it overlaps is weighted by the length of the overlap
+  double scale = (double)src_size / dst_size;
+  for (size_t i = 0; i < dst_size; i++) {
+    offsets.push_back(taps.size());
+
+    double start = i * scale;
+    double end = std::min((i + 1) * scale, (double)src_size);
+    for (size_t j = (size_t)start; j < end; j++) {
+      double overlap = std::min(j + 1.0, end) - std::max((double)j, start);
+      if (overlap <= 0) continue;
+
+      Tap tap;
+      tap.index = j;
+      tap.weight = overlap / (end - start);
+      taps.push_back(tap);
+    }
+  }
+  offsets.push_back(taps.size());
+}
+
+void ScreenPreprocessor::grayscaleRow(size_t r, pixel_t* row) {
+  MediaSource& media = m_osystem->console().mediaSource();
+  const uInt8* current = media.currentFrameBuffer() + r * m_src_width;
+  const uInt8* grayscale = m_grayscale;
+  const size_t width = m_src_width;
+
+  if (m_max_pool) {
+    const uInt8* previous = media.previousFrameBuffer() + r * m_src_width;
+    for (size_t c = 0; c < width; c++) {
+      row[c] = std::max(grayscale[current[c]], grayscale[previous[c]]);
+    }
+  }
+  else {
+    for (size_t c = 0; c < width; c++) {
+      row[c] = grayscale[current[c]];
+    }
+  }
+}
+
+void ScreenPreprocessor::process(pixel_t* buffer) {
+  // Without resizing, the grayscale rows are the output
+  if (m_height == m_src_height && m_width == m_src_width) {
+    for (size_t r = 0; r < m_height; r++) {
+      grayscaleRow(r, buffer + r * m_width);
+    }
+    return;
+  }
+
+  pixel_t* row = &m_row[0];
+  float* accumulator = &m_accumulator[0];
+  const size_t src_width = m_src_width;
+  const size_t column_taps = m_column_taps;
+
+  // Consecutive output rows may share a source row; only convert it once
+  int last_row = -1;
+
+  for (size_t r = 0; r < m_height; r++) {
+    // Resample vertically: blend the source rows covered by output row r
+    for (int t = m_row_offsets[r]; t < m_row_offsets[r + 1]; t++) {
+      const float weight = m_row_taps[t].weight;
+      if (m_row_taps[t].index != last_row) {
+        last_row = m_row_taps[t].index;
+        grayscaleRow(last_row, row);
+      }
+      if (t == m_row_offsets[r]) {
+        for (size_t c = 0; c < src_width; c++) accumulator[c] = weight * row[c];
+      }
+      else {
+        for (size_t c = 0; c < src_width; c++) accumulator[c] += weight * row[c];
+      }
+    }
+
+    // Then horizontally
+    pixel_t* out = buffer + r * m_width;
+    const int* index = &m_column_index[0];
+    const float* weight = &m_column_weight[0];
+    for (size_t c = 0; c < m_width; c++) {
+      float value = 0.5f;
+      for (size_t k = 0; k < column_taps; k++, index++, weight++) {
+        value += *weight * accumulator[*index];
+      }
+      out[c] = (pixel_t)std::min(value, 255.0f);
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and 
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details. 
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  screen_preprocessor.hpp
+ *
+ *  Turns the emulator's frame buffers into a grayscale, optionally max-pooled
+ *  and resized observation in a single pass.
+ *  
+ **************************************************************************** */
+
+#ifndef __SCREEN_PREPROCESSOR_HPP__
+#define __SCREEN_PREPROCESSOR_HPP__
+
+#include "../emucore/OSystem.hxx"
+#include "ale_screen.hpp"
+
+#include <vector>
+
+class ScreenPreprocessor {
+  public:
+    /** Reads the preprocess_* settings from the OSystem. */
+    ScreenPreprocessor(OSystem *);
+
+    /** Dimensions of the preprocessed screen */
+    size_t height() const { return m_height; }
+    size_t width() const { return m_width; }
+
+    /** Writes the preprocessed screen, height() x width() grayscale bytes, into buffer. When
+      *  max-pooling, each pixel is the brighter of the last two emulated frames. */
+    void process(pixel_t* buffer);
+
+  private:
+    /** A source pixel's contribution to one destination pixel along one axis */
+    struct Tap {
+      int index;
+      float weight;
+    };
+
+    /** Computes the area-averaging taps which shrink or stretch src_size pixels to dst_size */
+    static void makeTaps(size_t src_size, size_t dst_size, std::vector<Tap>& taps,
+                         std::vector<int>& offsets);
+
+    /** Writes the grayscale (max-pooled) source row r into row */
+    void grayscaleRow(size_t r, pixel_t* row);
+
+  private:
+    OSystem * m_osystem;
+
+    bool m_max_pool;
+    size_t m_src_height, m_src_width;
+    size_t m_height, m_width;
+
+    uInt8 m_grayscale[256]; // Grayscale value of each palette index
+
+    // Taps of output row i are m_row_taps[m_row_offsets[i] .. m_row_offsets[i + 1])
+    std::vector<Tap> m_row_taps;
+    std::vector<int> m_row_offsets;
+
+    // Output column i has m_column_taps taps, stored from i * m_column_taps on
+    size_t m_column_taps;
+    std::vector<int> m_column_index;
+    std::vector<float> m_column_weight;
+
+    std::vector<pixel_t> m_row; // One grayscale source row
+    std::vector<float> m_accumulator; // One vertically resampled row
+};
+
+#endif // __SCREEN_PREPROCESSOR_HPP__
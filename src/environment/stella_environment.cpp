@@ -23,10 +23,19 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
   m_osystem(osystem),
   m_settings(settings),
   m_phosphor_blend(osystem),  
+  m_preprocessor(osystem),
+  m_frame_stack(osystem, m_preprocessor),
+  m_num_saved_states(0),
   m_screen(m_osystem->console().mediaSource().height(),
         m_osystem->console().mediaSource().width()),
+  m_screen_dirty(true),
+  m_ram_dirty(true),
+  m_screen_buffer(NULL),
+  m_screen_buffer_format(SCREEN_PALETTE),
   m_player_a_action(PLAYER_A_NOOP),
-  m_player_b_action(PLAYER_B_NOOP) {
+  m_player_b_action(PLAYER_B_NOOP),
+  m_newest_kept_frame(0),
+  m_previous_frame_kept(false) {
 
   // Determine whether this is a paddle-based game
   if (m_osystem->console().properties().get(Controller_Left) == "PADDLES" ||
@@ -44,6 +53,13 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
 
   m_repeat_action_probability = m_osystem->settings().getFloat("repeat_action_probability");
   
+  // Without rendering, screens are never updated
+  if (m_osystem->settings().getBool("fast_tia_update") &&
+      (m_colour_averaging || m_frame_stack.enabled())) {
+    ale::Logger::Warning << "Warning: the screen is not drawn when fast_tia_update is set."
+      << std::endl;
+  }
+
   m_frame_skip = m_osystem->settings().getInt("frame_skip");
   if (m_frame_skip < 1) {
     ale::Logger::Warning << "Warning: frame skip set to < 1. Setting to 1." << std::endl;
@@ -58,11 +74,22 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
     // Create the screen exporter
     m_screen_exporter.reset(new ScreenExporter(m_osystem->colourPalette(), recordDir)); 
   }
+
+  // Only the last two frames of each act() are needed for observations (max-pooling and colour
+  //  averaging read the previous frame), unless all frames are recorded or none are drawn
+  m_render_final_frames = m_osystem->settings().getBool("render_final_frames") &&
+    m_screen_exporter.get() == NULL && !m_osystem->settings().getBool("fast_tia_update");
+
+  // Without display audio or sound recording the audio path is disconnected
+  m_sound_consumed = m_osystem->sound().isConsumed();
+  // Frames emulated again to draw them would also play their sound twice
+  m_render_final_frames = m_render_final_frames && !m_sound_consumed;
 }
 
 /** Resets the system to its start state. */
 void StellaEnvironment::reset() {
   m_state.resetEpisodeFrameNumber();
+  m_previous_frame_kept = false;
   // Reset the paddles
   m_state.resetPaddles(m_osystem->event());
 
@@ -89,38 +116,94 @@ void StellaEnvironment::reset() {
   for (size_t i = 0; i < startingActions.size(); i++){
     emulate(startingActions[i], PLAYER_B_NOOP);
   }
+
+  // The episode's history is its first screen
+  m_frame_stack.fill();
+
+  writeScreenBuffer();
 }
 
 /** Save/restore the environment state. */
 void StellaEnvironment::save() {
-  // Store the current state into a new object
-  ALEState new_state = cloneState();
-  m_saved_states.push(new_state);
+  // Store the current state into the next free object
+  if (m_num_saved_states == m_saved_states.size())
+    m_saved_states.push_back(ALEState());
+  cloneState(m_saved_states[m_num_saved_states++]);
 }
 
 void StellaEnvironment::load() {
   // Get the state on top of the stack
-  ALEState& target_state = m_saved_states.top(); 
+  ALEState& target_state = m_saved_states[m_num_saved_states - 1];
  
   // Deserialize it into 'm_state'
   restoreState(target_state);
-  m_saved_states.pop();
+  m_num_saved_states--;
 }
 
 ALEState StellaEnvironment::cloneState() {
-  return m_state.save(m_osystem, m_settings, m_cartridge_md5, false);
+  ALEState state = m_state.save(m_osystem, m_settings, m_cartridge_md5, false);
+  saveFrameStack(state);
+  return state;
+}
+
+void StellaEnvironment::cloneState(ALEState& state) {
+  m_state.save(m_osystem, m_settings, m_cartridge_md5, false, state);
+  saveFrameStack(state);
 }
 
 void StellaEnvironment::restoreState(const ALEState& target_state) {
   m_state.load(m_osystem, m_settings, m_cartridge_md5, target_state, false);
+  m_ram_dirty = true;
+  m_previous_frame_kept = false;
+  loadFrameStack(target_state);
+}
+
+void StellaEnvironment::restoreState(const char* serialized, size_t size) {
+  m_state.load(m_osystem, m_settings, m_cartridge_md5, serialized, size, false);
+  m_ram_dirty = true;
+  m_previous_frame_kept = false;
+  // Serialized states carry no frame stack, so it restarts from the restored screen
+  if (m_frame_stack.enabled())
+    m_frame_stack.fill();
+}
+
+ALEState StellaEnvironment::cloneDeltaState(const ALEState& base) {
+  return cloneState().deltaFrom(base);
+}
+
+uint64_t StellaEnvironment::stateHash() {
+  return m_state.hash(m_osystem, m_settings, m_hash_buffer);
 }
 
 ALEState StellaEnvironment::cloneSystemState() {
-  return m_state.save(m_osystem, m_settings, m_cartridge_md5, true);
+  ALEState state = m_state.save(m_osystem, m_settings, m_cartridge_md5, true);
+  saveFrameStack(state);
+  return state;
 }
 
 void StellaEnvironment::restoreSystemState(const ALEState& target_state) {
   m_state.load(m_osystem, m_settings, m_cartridge_md5, target_state, true);
+  m_ram_dirty = true;
+  m_previous_frame_kept = false;
+  loadFrameStack(target_state);
+}
+
+void StellaEnvironment::restoreSystemState(const char* serialized, size_t size) {
+  m_state.load(m_osystem, m_settings, m_cartridge_md5, serialized, size, true);
+  m_ram_dirty = true;
+  m_previous_frame_kept = false;
+  if (m_frame_stack.enabled())
+    m_frame_stack.fill();
+}
+
+void StellaEnvironment::saveFrameStack(ALEState& state) {
+  if (m_frame_stack.enabled())
+    state.setFrames(m_frame_stack.share());
+}
+
+void StellaEnvironment::loadFrameStack(const ALEState& state) {
+  if (m_frame_stack.enabled())
+    m_frame_stack.load(state.getFrames());
 }
 
 void StellaEnvironment::noopIllegalActions(Action & player_a_action, Action & player_b_action) {
@@ -160,19 +243,70 @@ reward_t StellaEnvironment::act(Action player_a_action, Action player_b_action)
 
     // If so desired, request one frame's worth of sound (this does nothing if recording
     // is not enabled)
-    m_osystem->sound().recordNextFrame();
+    if (m_sound_consumed)
+      m_osystem->sound().recordNextFrame();
 
     // Similarly record screen as needed
     if (m_screen_exporter.get() != NULL)
-        m_screen_exporter->saveNext(m_screen);
+        m_screen_exporter->saveNext(getScreen());
+
+    // Skip drawing frames which are overwritten before the end of this act(); drawing is back
+    //  on for the last frames, so that everything else always renders. Should the episode end
+    //  on an undrawn frame, it is emulated again along with the frame before it, so the state
+    //  before a frame is kept whenever it or the next frame (possibly the first of the next
+    //  act()) may be left undrawn.
+    bool keep_frame = m_render_final_frames && m_frame_skip > 2 && !isTerminal() &&
+      (i + 2 < m_frame_skip || i + 1 == m_frame_skip);
+    bool skip_drawing = keep_frame && i + 2 < m_frame_skip && (i > 0 || m_previous_frame_kept);
+    if (m_render_final_frames)
+      m_osystem->console().mediaSource().setRendering(!skip_drawing);
+    if (keep_frame)
+      keepFrame();
+    m_previous_frame_kept = keep_frame;
 
     // Use the stored actions, which may or may not have changed this frame
     sum_rewards += oneStepAct(m_player_a_action, m_player_b_action);
+
+    if (skip_drawing && isTerminal())
+      redrawKeptFrames();
   }
 
+  m_frame_stack.push();
+  writeScreenBuffer();
+
   return sum_rewards;
 }
 
+void StellaEnvironment::keepFrame() {
+  m_newest_kept_frame ^= 1;
+  KeptFrame& kept = m_kept_frames[m_newest_kept_frame];
+  m_state.save(m_osystem, m_settings, m_cartridge_md5, false, kept.state);
+  kept.player_a_action = m_player_a_action;
+  kept.player_b_action = m_player_b_action;
+}
+
+void StellaEnvironment::redrawKeptFrames() {
+  // The TIA swaps its two frame buffers at the start of every frame, which restoring a state
+  //  does not undo, so both kept frames are emulated again to leave each buffer in its place.
+  //  Their rewards are already counted.
+  const KeptFrame& previous = m_kept_frames[m_newest_kept_frame ^ 1];
+  const KeptFrame& last = m_kept_frames[m_newest_kept_frame];
+  m_state.load(m_osystem, m_settings, m_cartridge_md5, previous.state, false);
+  m_osystem->console().mediaSource().setRendering(true);
+  oneStepAct(previous.player_a_action, previous.player_b_action);
+  oneStepAct(last.player_a_action, last.player_b_action);
+}
+
+void StellaEnvironment::getLastActions(Action& player_a_action, Action& player_b_action) const {
+  player_a_action = m_player_a_action;
+  player_b_action = m_player_b_action;
+}
+
+void StellaEnvironment::setLastActions(Action player_a_action, Action player_b_action) {
+  m_player_a_action = player_a_action;
+  m_player_b_action = player_b_action;
+}
+
 /** This functions emulates a push on the reset button of the console */
 void StellaEnvironment::softReset() {
   emulate(RESET, PLAYER_B_NOOP, m_num_reset_steps);
@@ -209,8 +343,6 @@ void StellaEnvironment::pressSelect(size_t num_steps) {
   for (size_t t = 0; t < num_steps; t++) {
     m_osystem->console().mediaSource().update();
   }
-  processScreen();
-  processRAM();
   emulate(PLAYER_A_NOOP, PLAYER_B_NOOP);
   m_state.incrementFrame();
 }
@@ -247,9 +379,9 @@ void StellaEnvironment::emulate(Action player_a_action, Action player_b_action,
     }
   }
 
-  // Parse screen and RAM into their respective data structures
-  processScreen();
-  processRAM();
+  // Screen and RAM are parsed into their respective data structures on demand
+  m_screen_dirty = true;
+  m_ram_dirty = true;
 }
 
 /** Accessor methods for the environment state. */
@@ -265,6 +397,22 @@ std::unique_ptr<StellaEnvironmentWrapper> StellaEnvironment::getWrapper() {
     return std::unique_ptr<StellaEnvironmentWrapper>(new StellaEnvironmentWrapper(*this));
 }
 
+const ALEScreen& StellaEnvironment::getScreen() {
+  if (m_screen_dirty) {
+    processScreen();
+    m_screen_dirty = false;
+  }
+  return m_screen;
+}
+
+const ALERAM& StellaEnvironment::getRAM() {
+  if (m_ram_dirty) {
+    processRAM();
+    m_ram_dirty = false;
+  }
+  return m_ram;
+}
+
 void StellaEnvironment::processScreen() {
   if (m_colour_averaging) {
     // Perform phosphor averaging; the blender stores its result in the given screen
@@ -277,6 +425,40 @@ void StellaEnvironment::processScreen() {
   }
 }
 
+void StellaEnvironment::setScreenBuffer(pixel_t* buffer, ScreenFormat format) {
+  m_screen_buffer = buffer;
+  m_screen_buffer_format = format;
+
+  writeScreenBuffer();
+}
+
+void StellaEnvironment::writeScreenBuffer() {
+  if (m_screen_buffer == NULL) return;
+
+  // The preprocessor reads the emulator's frame buffers itself
+  if (m_screen_buffer_format == SCREEN_PREPROCESSED) {
+    m_preprocessor.process(m_screen_buffer);
+    return;
+  }
+
+  // Without colour averaging the frame buffer is the screen, so read it directly
+  pixel_t* src = m_colour_averaging ? getScreen().getArray() :
+    m_osystem->console().mediaSource().currentFrameBuffer();
+  size_t size = m_screen.arraySize();
+
+  switch (m_screen_buffer_format) {
+    case SCREEN_RGB:
+      m_osystem->colourPalette().applyPaletteRGB(m_screen_buffer, src, size);
+      break;
+    case SCREEN_GRAYSCALE:
+      m_osystem->colourPalette().applyPaletteGrayscale(m_screen_buffer, src, size);
+      break;
+    default:
+      memcpy(m_screen_buffer, src, size);
+      break;
+  }
+}
+
 void StellaEnvironment::processRAM() {
   // Copy RAM over
   for (size_t i = 0; i < m_ram.size(); i++)
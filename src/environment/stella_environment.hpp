@@ -22,6 +22,8 @@
 #include "ale_screen.hpp"
 #include "ale_state.hpp"
 #include "phosphor_blend.hpp"
+#include "screen_preprocessor.hpp"
+#include "frame_stack.hpp"
 #include "stella_environment_wrapper.hpp"
 #include "../emucore/Event.hxx"
 #include "../emucore/OSystem.hxx"
@@ -30,7 +32,7 @@
 #include "../common/Log.hpp"
 #include "../common/ScreenExporter.hpp"
 
-#include <stack>
+#include <vector>
 #include <memory>
 
 class StellaEnvironment {
@@ -47,14 +49,26 @@ class StellaEnvironment {
     /** Returns a copy of the current emulator state. Note that this doesn't include
         pseudorandomness, so that clone/restoreState are suitable for planning. */
     ALEState cloneState();
+    /** Stores a copy of the current emulator state into state, reusing its storage. */
+    void cloneState(ALEState& state);
     /** Restores a previously saved copy of the state. */
     void restoreState(const ALEState&);
+    /** Restores a state from the output of ALEState::serialize(), without copying it. */
+    void restoreState(const char* serialized, size_t size);
+
+    /** Like cloneState(), but the copy only stores its differences from base. */
+    ALEState cloneDeltaState(const ALEState& base);
+
+    /** Returns a 64-bit hash of the state cloneState() would copy, without copying it. */
+    uint64_t stateHash();
 
     /** Returns a copy of the current emulator state. This includes RNG state information, and
         more generally should lead to exactly reproducibility. */
     ALEState cloneSystemState();
     /** Restores a previously saved copy of the state, including RNG state information. */
     void restoreSystemState(const ALEState&);
+    /** As restoreState(const char*, size_t), for a state returned by cloneSystemState(). */
+    void restoreSystemState(const char* serialized, size_t size);
 
     /** Applies the given actions (e.g. updating paddle positions when the paddle is used)
       *  and performs one simulation step in Stella. Returns the resultant reward. When 
@@ -64,6 +78,11 @@ class StellaEnvironment {
       */
     reward_t act(Action player_a_action, Action player_b_action);
 
+    /** The actions last applied to the emulator, which act() repeats when an action is dropped
+      *  by repeat_action_probability. They are not part of saved states. */
+    void getLastActions(Action& player_a_action, Action& player_b_action) const;
+    void setLastActions(Action player_a_action, Action player_b_action);
+
     /** This functions emulates a push on the reset button of the console */
     void softReset();
 
@@ -89,9 +108,22 @@ class StellaEnvironment {
     void setState(const ALEState & state);
     const ALEState &getState() const;
 
-    /** Returns the current screen after processing (e.g. colour averaging) */
-    const ALEScreen &getScreen() const { return m_screen; }
-    const ALERAM &getRAM() const { return m_ram; }
+    /** Returns the current screen after processing (e.g. colour averaging), and the
+      *  current RAM. Both are only extracted from the emulator when requested. */
+    const ALEScreen &getScreen();
+    const ALERAM &getRAM();
+
+    /** Registers a caller-owned buffer which receives the screen, in the given format, at
+      *  the end of every act() and reset(). The buffer is filled once right away; it must
+      *  hold width x height pixels (three bytes per pixel for SCREEN_RGB) and outlive this
+      *  environment, or be unregistered by passing NULL. */
+    void setScreenBuffer(pixel_t* buffer, ScreenFormat format);
+
+    /** Returns the preprocessor configured by the preprocess_* settings. */
+    ScreenPreprocessor& getScreenPreprocessor() { return m_preprocessor; }
+
+    /** Returns the last frame_stack preprocessed screens. */
+    const FrameStack& getFrameStack() const { return m_frame_stack; }
 
     int getFrameNumber() const { return m_state.getFrameNumber(); }
     int getEpisodeFrameNumber() const { return m_state.getEpisodeFrameNumber(); }
@@ -114,18 +146,40 @@ class StellaEnvironment {
     void processScreen();
     /** Processes the emulator RAM and saves it in m_ram */
     void processRAM();
+    /** Writes the current screen into the caller-owned buffer, if one is registered */
+    void writeScreenBuffer();
+
+    /** Keeps the state before the next frame, and emulates the last two kept frames again with
+      *   drawing on, once an undrawn frame has ended the episode */
+    void keepFrame();
+    void redrawKeptFrames();
+
+    /** Stores the frame stack in a state just saved, and restores it from a state */
+    void saveFrameStack(ALEState& state);
+    void loadFrameStack(const ALEState& state);
 
   private:
     OSystem *m_osystem;
     RomSettings *m_settings;
     PhosphorBlend m_phosphor_blend; // For performing phosphor colour averaging, if so desired
+    ScreenPreprocessor m_preprocessor; // Produces preprocessed observations
+    FrameStack m_frame_stack; // The last few preprocessed observations, if so desired
     std::string m_cartridge_md5; // Necessary for saving and loading emulator state
 
-    std::stack<ALEState> m_saved_states; // States are saved on a stack
+    std::string m_hash_buffer; // Scratch space for stateHash(), kept to avoid allocating
+
+    // States are saved on a stack. Popped states are kept so that their storage can be reused.
+    std::vector<ALEState> m_saved_states;
+    size_t m_num_saved_states;
     
     ALEState m_state; // Current environment state    
     ALEScreen m_screen; // The current ALE screen (possibly colour-averaged)
     ALERAM m_ram; // The current ALE RAM
+    bool m_screen_dirty; // Whether m_screen lags behind the emulator
+    bool m_ram_dirty; // Whether m_ram lags behind the emulator
+
+    pixel_t* m_screen_buffer; // Caller-owned screen buffer, or NULL
+    ScreenFormat m_screen_buffer_format; // Format in which m_screen_buffer is written
 
     bool m_use_paddles;  // Whether this game uses paddles
     
@@ -134,11 +188,22 @@ class StellaEnvironment {
     bool m_colour_averaging; // Whether to average frames
     int m_max_num_frames_per_episode; // Maxmimum number of frames per episode 
     size_t m_frame_skip; // How many frames to emulate per act()
+    bool m_render_final_frames; // Whether only the last two frames of each act() are drawn
+    bool m_sound_consumed; // Whether the sound device plays or records the emulated audio
     float m_repeat_action_probability; // Stochasticity of the environment
     std::unique_ptr<ScreenExporter> m_screen_exporter; // Automatic screen recorder
 
     // The last actions taken by our players
     Action m_player_a_action, m_player_b_action;
+
+    // The state before each of the last two kept frames, and the actions emulated in them
+    struct KeptFrame {
+      ALEState state;
+      Action player_a_action, player_b_action;
+    };
+    KeptFrame m_kept_frames[2];
+    int m_newest_kept_frame; // Index of the last kept frame in m_kept_frames
+    bool m_previous_frame_kept; // Whether the last frame emulated was kept
 };
 
 #endif // __STELLA_ENVIRONMENT_HPP__
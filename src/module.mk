@@ -2,7 +2,10 @@ MODULE := src/
 
 MODULE_OBJS := \
 	src/main.o \
-	src/ale_interface.o
+	src/ale_interface.o \
+	src/ale_vector_interface.o \
+	src/ale_episode.o \
+	src/ale_rollout_pool.o
 
 MODULE_DIRS += \
 	src/